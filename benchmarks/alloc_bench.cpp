@@ -0,0 +1,363 @@
+// allocation throughput of __default_alloc_template against the system
+// malloc (malloc_alloc) across 1..N threads
+//
+// every (pattern, allocator, threads) run happens in a forked child so that
+// the memory pool and the peak RSS start fresh; this benchmark is POSIX only
+//
+// usage: alloc_bench [--threads=N] [--ops=M] [--json=<path>]
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocator.h"
+#include "list.h"
+#include "rbench.h"
+#include "vector.h"
+
+namespace bench {
+typedef tinystl::__default_alloc_template<true, 0> pool_alloc;
+typedef tinystl::malloc_alloc system_alloc;
+
+struct thread_stats {
+   size_t ops;
+   size_t peak_live;  // requested bytes alive at the same time
+};
+
+struct run_result {
+   double ops_per_sec;
+   long peak_rss_kb;
+   double fragmentation;
+};
+
+// cheap generator so that the allocator dominates the measurement
+struct xorshift {
+   unsigned long long state;
+   explicit xorshift(unsigned long long seed)
+       : state(seed * 2654435761ULL + 1) {}
+   size_t operator()() {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return static_cast<size_t>(state);
+   }
+};
+
+// value of a "<field>: <n> kB" line in /proc/self/status
+static long read_status_kb(const char* field) {
+   std::ifstream in("/proc/self/status");
+   std::string line;
+   size_t len = std::strlen(field);
+   while (std::getline(in, line)) {
+      if (line.compare(0, len, field) == 0 && line[len] == ':')
+         return std::atol(line.c_str() + len + 1);
+   }
+   return 0;
+}
+
+// allocate and free random sizes in [1, max_bytes] over a window of slots
+template <class Alloc>
+void random_sizes(size_t max_bytes, size_t ops, unsigned seed,
+                  thread_stats& stats) {
+   enum { window = 4096 };
+   std::vector<void*> ptr(window, static_cast<void*>(0));
+   std::vector<size_t> size(window, 0);
+   xorshift gen(seed);
+   size_t live = 0;
+   stats.peak_live = 0;
+   for (size_t i = 0; i < ops; ++i) {
+      size_t k = gen() % window;
+      if (ptr[k]) {
+         Alloc::deallocate(ptr[k], size[k]);
+         live -= size[k];
+      }
+      size[k] = 1 + gen() % max_bytes;
+      ptr[k] = Alloc::allocate(size[k]);
+      *static_cast<char*>(ptr[k]) = 1;
+      live += size[k];
+      if (live > stats.peak_live) stats.peak_live = live;
+   }
+   for (size_t k = 0; k < window; ++k) {
+      if (ptr[k]) Alloc::deallocate(ptr[k], size[k]);
+   }
+   stats.ops = ops;
+}
+
+// single producer single consumer queue of (pointer, size)
+struct handoff_queue {
+   enum { capacity = 1024 };
+   std::pair<void*, size_t> slots[capacity];
+   std::atomic<size_t> head;
+   std::atomic<size_t> tail;
+   handoff_queue() : head(0), tail(0) {}
+   bool push(void* p, size_t n) {
+      size_t t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == capacity) return false;
+      slots[t % capacity] = std::make_pair(p, n);
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+   }
+   bool pop(std::pair<void*, size_t>& out) {
+      size_t h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire)) return false;
+      out = slots[h % capacity];
+      head.store(h + 1, std::memory_order_release);
+      return true;
+   }
+};
+
+// memory allocated on one thread and freed on another
+template <class Alloc>
+void producer(handoff_queue& q, size_t ops, unsigned seed,
+              thread_stats& stats) {
+   xorshift gen(seed);
+   for (size_t i = 0; i < ops; ++i) {
+      size_t n = 1 + gen() % tinystl::__MAX_BYTES;
+      void* p = Alloc::allocate(n);
+      while (!q.push(p, n)) std::this_thread::yield();
+   }
+   stats.ops = ops;
+   stats.peak_live =
+       static_cast<size_t>(handoff_queue::capacity) * tinystl::__MAX_BYTES;
+}
+
+template <class Alloc>
+void consumer(handoff_queue& q, size_t ops, thread_stats& stats) {
+   std::pair<void*, size_t> item;
+   for (size_t i = 0; i < ops; ++i) {
+      while (!q.pop(item)) std::this_thread::yield();
+      Alloc::deallocate(item.first, item.second);
+   }
+   stats.ops = 0;  // counted by the producer
+   stats.peak_live = 0;
+}
+
+// create_node/destroy_node churn through push_back and pop_front
+template <class Alloc>
+void list_churn(size_t ops, thread_stats& stats) {
+   enum { live_nodes = 4096 };
+   tinystl::list<int, Alloc> l;
+   for (int i = 0; i < live_nodes; ++i) l.push_back(i);
+   for (size_t i = 0; i < ops; ++i) {
+      l.push_back(static_cast<int>(i));
+      l.pop_front();
+   }
+   l.clear();
+   stats.ops = ops;
+   stats.peak_live = (live_nodes + 1) * sizeof(tinystl::__list_node<int>);
+}
+
+// vectors growing from empty, one op per push_back
+template <class Alloc>
+void vector_growth(size_t ops, thread_stats& stats) {
+   enum { length = 4096 };
+   size_t done = 0;
+   while (done < ops) {
+      tinystl::vector<int, Alloc> v;
+      for (int i = 0; i < length; ++i) v.push_back(i);
+      rtest::DoNotOptimize(v.begin());
+      done += length;
+   }
+   stats.ops = done;
+   // the old buffer is alive while it is copied to the new one
+   stats.peak_live = 3 * length / 2 * sizeof(int);
+}
+
+enum pattern_id {
+   SMALL_SIZES,
+   MIXED_SIZES,
+   PRODUCER_CONSUMER,
+   LIST_CHURN,
+   VECTOR_GROWTH
+};
+static const char* pattern_names[] = {"random_small", "random_mixed",
+                                      "producer_consumer", "list_churn",
+                                      "vector_growth"};
+
+template <class Alloc>
+run_result run_threads(pattern_id pattern, int threads, size_t ops) {
+   std::vector<thread_stats> stats(threads);
+   std::vector<std::thread> workers;
+   std::vector<handoff_queue*> queues;
+   long base_rss_kb = read_status_kb("VmRSS");
+
+   std::chrono::steady_clock::time_point start =
+       std::chrono::steady_clock::now();
+   for (int t = 0; t < threads; ++t) {
+      thread_stats& st = stats[t];
+      unsigned seed = static_cast<unsigned>(t + 1);
+      switch (pattern) {
+         case SMALL_SIZES:
+            workers.emplace_back([&st, ops, seed]() {
+               random_sizes<Alloc>(tinystl::__MAX_BYTES, ops, seed, st);
+            });
+            break;
+         case MIXED_SIZES:
+            workers.emplace_back([&st, ops, seed]() {
+               random_sizes<Alloc>(8 * tinystl::__MAX_BYTES, ops, seed, st);
+            });
+            break;
+         case PRODUCER_CONSUMER:
+            // threads are paired, an odd thread out produces and consumes
+            if (t % 2 == 0) {
+               queues.push_back(new handoff_queue);
+               handoff_queue& q = *queues.back();
+               if (t + 1 < threads) {
+                  workers.emplace_back([&q, &st, ops, seed]() {
+                     producer<Alloc>(q, ops, seed, st);
+                  });
+               } else {
+                  workers.emplace_back([&q, &st, ops, seed]() {
+                     thread_stats ignored;
+                     std::thread c(
+                         [&q, ops, &ignored]() {
+                            consumer<Alloc>(q, ops, ignored);
+                         });
+                     producer<Alloc>(q, ops, seed, st);
+                     c.join();
+                  });
+               }
+            } else {
+               handoff_queue& q = *queues.back();
+               workers.emplace_back(
+                   [&q, &st, ops]() { consumer<Alloc>(q, ops, st); });
+            }
+            break;
+         case LIST_CHURN:
+            workers.emplace_back([&st, ops]() { list_churn<Alloc>(ops, st); });
+            break;
+         case VECTOR_GROWTH:
+            workers.emplace_back(
+                [&st, ops]() { vector_growth<Alloc>(ops, st); });
+            break;
+      }
+   }
+   for (size_t t = 0; t < workers.size(); ++t) workers[t].join();
+   double seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+   for (size_t i = 0; i < queues.size(); ++i) delete queues[i];
+
+   run_result r;
+   size_t total_ops = 0, live = 0;
+   for (int t = 0; t < threads; ++t) {
+      total_ops += stats[t].ops;
+      live += stats[t].peak_live;
+   }
+   r.ops_per_sec = total_ops / seconds;
+   r.peak_rss_kb = read_status_kb("VmHWM");
+   long grown_kb = r.peak_rss_kb - base_rss_kb;
+   r.fragmentation =
+       grown_kb > 0 ? 1.0 - static_cast<double>(live) / (grown_kb * 1024.0)
+                    : 0.0;
+   if (r.fragmentation < 0) r.fragmentation = 0;
+   return r;
+}
+
+// run in a child process and send the result back through a pipe
+template <class Alloc>
+run_result run_isolated(pattern_id pattern, int threads, size_t ops) {
+   int fds[2];
+   run_result r = {0, 0, 0};
+   if (pipe(fds) != 0) return r;
+   pid_t pid = fork();
+   if (pid == 0) {
+      close(fds[0]);
+      r = run_threads<Alloc>(pattern, threads, ops);
+      ssize_t written = write(fds[1], &r, sizeof(r));
+      _exit(written == sizeof(r) ? 0 : 1);
+   }
+   close(fds[1]);
+   if (read(fds[0], &r, sizeof(r)) != sizeof(r)) r = run_result{0, 0, 0};
+   close(fds[0]);
+   waitpid(pid, 0, 0);
+   return r;
+}
+
+struct report_row {
+   std::string pattern;
+   std::string alloc;
+   int threads;
+   run_result result;
+};
+
+static void print_row(const report_row& row, double baseline_ops) {
+   char line[256];
+   std::snprintf(line, sizeof(line), "%-18s %-8s %8d %12.2f %14.1f %10.2f",
+                 row.pattern.c_str(), row.alloc.c_str(), row.threads,
+                 row.result.ops_per_sec / 1e6, row.result.peak_rss_kb / 1024.0,
+                 row.result.fragmentation);
+   std::cout << line;
+   if (baseline_ops > 0) {
+      std::snprintf(line, sizeof(line), " %8.2fx",
+                    row.result.ops_per_sec / baseline_ops);
+      std::cout << line;
+   }
+   std::cout << std::endl;
+}
+
+static void write_json(const std::string& path,
+                       const std::vector<report_row>& rows) {
+   std::ofstream out(path);
+   out << "{\n  \"allocations\": [";
+   for (size_t i = 0; i < rows.size(); ++i) {
+      const report_row& row = rows[i];
+      out << (i ? ",\n" : "\n") << "    {\"pattern\": \"" << row.pattern
+          << "\", \"alloc\": \"" << row.alloc
+          << "\", \"threads\": " << row.threads
+          << ", \"ops_per_sec\": " << row.result.ops_per_sec
+          << ", \"peak_rss_kb\": " << row.result.peak_rss_kb
+          << ", \"fragmentation\": " << row.result.fragmentation << "}";
+   }
+   out << "\n  ]\n}\n";
+}
+
+void alloc_bench(int max_threads, size_t ops, const std::string& json_path) {
+   std::vector<report_row> rows;
+   char line[256];
+   std::snprintf(line, sizeof(line), "%-18s %-8s %8s %12s %14s %10s %9s",
+                 "Pattern", "Alloc", "Threads", "Mops/s", "PeakRSS(MB)",
+                 "Frag", "vs malloc");
+   std::cout << line << '\n';
+   for (int p = SMALL_SIZES; p <= VECTOR_GROWTH; ++p) {
+      pattern_id pattern = static_cast<pattern_id>(p);
+      for (int threads = 1;; threads *= 2) {
+         if (threads > max_threads) threads = max_threads;
+         report_row base = {pattern_names[p], "malloc", threads,
+                            run_isolated<system_alloc>(pattern, threads, ops)};
+         report_row pool = {pattern_names[p], "pool", threads,
+                            run_isolated<pool_alloc>(pattern, threads, ops)};
+         print_row(base, 0);
+         print_row(pool, base.result.ops_per_sec);
+         rows.push_back(base);
+         rows.push_back(pool);
+         if (threads == max_threads) break;
+      }
+   }
+   if (!json_path.empty()) write_json(json_path, rows);
+}
+}  // namespace bench
+
+int main(int argc, char** argv) {
+   int threads = static_cast<int>(std::thread::hardware_concurrency());
+   size_t ops = 1000000;
+   std::string json_path;
+   for (int i = 1; i < argc; ++i) {
+      std::string a = argv[i];
+      if (a.compare(0, 10, "--threads=") == 0)
+         threads = std::stoi(a.substr(10));
+      if (a.compare(0, 6, "--ops=") == 0) ops = std::stoul(a.substr(6));
+      if (a.compare(0, 7, "--json=") == 0) json_path = a.substr(7);
+   }
+   if (threads < 1) threads = 1;
+   bench::alloc_bench(threads, ops, json_path);
+   return 0;
+}
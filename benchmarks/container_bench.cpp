@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithm.h"
+#include "list.h"
+#include "lru_cache.h"
+#include "rbench.h"
+#include "segmented_vector.h"
+#include "slot_map.h"
+#include "vector.h"
+
+namespace bench {
+static std::vector<int> random_ints(long long n) {
+   std::vector<int> v;
+   std::mt19937 generator(42);
+   for (long long i = 0; i < n; ++i) {
+      v.push_back(static_cast<int>(generator()));
+   }
+   return v;
+}
+
+static void move_to_back(tinystl::list<int>& l,
+                         tinystl::list<int>::iterator i) {
+   l.splice(l.end(), i);
+}
+static void move_to_back(std::list<int>& l, std::list<int>::iterator i) {
+   l.splice(l.end(), l, i);
+}
+
+// n elements whose nodes are linked in a random order of their addresses
+template <class List>
+static void churned_list(List& l, long long n) {
+   std::vector<typename List::iterator> nodes;
+   for (long long i = 0; i < n; ++i) {
+      l.push_back(1);
+      nodes.push_back(--l.end());
+   }
+   std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+   for (size_t i = 0; i < nodes.size(); ++i) move_to_back(l, nodes[i]);
+}
+
+void container_bench() {
+   const std::vector<long long> sizes =
+       rtest::Benchmarker::range(1 << 8, 1 << 16);
+
+   rtest::Benchmarker::add_comparison(
+       "vector/push_back",
+       [](rtest::State& state) {
+          while (state.keep_running()) {
+             tinystl::vector<int> v;
+             for (long long i = 0; i < state.range(); ++i) v.push_back(i);
+             rtest::DoNotOptimize(v.begin());
+             rtest::ClobberMemory();
+          }
+       },
+       [](rtest::State& state) {
+          while (state.keep_running()) {
+             std::vector<int> v;
+             for (long long i = 0; i < state.range(); ++i) v.push_back(i);
+             rtest::DoNotOptimize(v.data());
+             rtest::ClobberMemory();
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "vector/iterate",
+       [](rtest::State& state) {
+          tinystl::vector<int> v(static_cast<size_t>(state.range()), 1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (int* it = v.begin(); it != v.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       [](rtest::State& state) {
+          std::vector<int> v(static_cast<size_t>(state.range()), 1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = v.begin(); it != v.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "vector/sort",
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          tinystl::vector<int> v;
+          for (int x : input) v.push_back(x);
+          while (state.keep_running()) {
+             std::copy(input.begin(), input.end(), v.begin());
+             tinystl::sort(v.begin(), v.end());
+             rtest::ClobberMemory();
+          }
+       },
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          std::vector<int> v(input);
+          while (state.keep_running()) {
+             std::copy(input.begin(), input.end(), v.begin());
+             std::sort(v.begin(), v.end());
+             rtest::ClobberMemory();
+          }
+       },
+       sizes);
+
+   // the filter scans, see simd.h
+   rtest::Benchmarker::add_comparison(
+       "vector/scan",
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          tinystl::vector<int> v(input.data(), input.data() + input.size());
+          while (state.keep_running()) {
+             rtest::DoNotOptimize(tinystl::find(v.begin(), v.end(), 0));
+             rtest::DoNotOptimize(tinystl::count(v.begin(), v.end(), 1));
+             rtest::DoNotOptimize(tinystl::minmax_element(v.begin(), v.end()));
+             rtest::DoNotOptimize(tinystl::accumulate(v.begin(), v.end(), 0));
+          }
+       },
+       [](rtest::State& state) {
+          std::vector<int> v = random_ints(state.range());
+          while (state.keep_running()) {
+             rtest::DoNotOptimize(std::find(v.begin(), v.end(), 0));
+             rtest::DoNotOptimize(std::count(v.begin(), v.end(), 1));
+             rtest::DoNotOptimize(std::minmax_element(v.begin(), v.end()));
+             rtest::DoNotOptimize(std::accumulate(v.begin(), v.end(), 0));
+          }
+       },
+       sizes);
+
+   // pointer-stable containers, compared with std::deque
+   rtest::Benchmarker::add_comparison(
+       "segmented_vector/iterate",
+       [](rtest::State& state) {
+          tinystl::segmented_vector<int> v(static_cast<size_t>(state.range()),
+                                           1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = v.begin(); it != v.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       [](rtest::State& state) {
+          std::deque<int> v(static_cast<size_t>(state.range()), 1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = v.begin(); it != v.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       sizes);
+
+   // a cache of a quarter of the keys, against the list and map idiom
+   rtest::Benchmarker::add_comparison(
+       "lru_cache/get_or_put",
+       [](rtest::State& state) {
+          std::vector<int> keys = random_ints(state.range());
+          const size_t capacity = static_cast<size_t>(state.range() / 4);
+          while (state.keep_running()) {
+             tinystl::lru_cache<int, int> cache(capacity);
+             for (int k : keys) {
+                int key = k & 1023;
+                if (!cache.get(key)) cache.put(key, k);
+             }
+             rtest::DoNotOptimize(cache.hits());
+          }
+       },
+       [](rtest::State& state) {
+          typedef std::list<std::pair<int, int>> order_list;
+          std::vector<int> keys = random_ints(state.range());
+          const size_t capacity = static_cast<size_t>(state.range() / 4);
+          while (state.keep_running()) {
+             order_list order;
+             std::unordered_map<int, order_list::iterator> index;
+             size_t hits = 0;
+             for (int k : keys) {
+                int key = k & 1023;
+                auto it = index.find(key);
+                if (it != index.end()) {
+                   ++hits;
+                   order.splice(order.begin(), order, it->second);
+                   continue;
+                }
+                order.push_front(std::make_pair(key, k));
+                index[key] = order.begin();
+                if (order.size() > capacity) {
+                   index.erase(order.back().first);
+                   order.pop_back();
+                }
+             }
+             rtest::DoNotOptimize(hits);
+          }
+       },
+       sizes);
+
+   // a third of the entities erased, then a pass over the rest, against
+   // the unordered_map of handles it replaces
+   rtest::Benchmarker::add_comparison(
+       "slot_map/iterate",
+       [](rtest::State& state) {
+          tinystl::slot_map<int> m;
+          std::vector<tinystl::slot_key> keys;
+          for (long long i = 0; i < state.range(); ++i) {
+             keys.push_back(m.insert(1));
+          }
+          for (size_t i = 0; i < keys.size(); i += 3) m.erase(keys[i]);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (int* it = m.begin(); it != m.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       [](rtest::State& state) {
+          std::unordered_map<unsigned, int> m;
+          for (long long i = 0; i < state.range(); ++i) {
+             m[static_cast<unsigned>(i)] = 1;
+          }
+          for (long long i = 0; i < state.range(); i += 3) {
+             m.erase(static_cast<unsigned>(i));
+          }
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "list/push_back",
+       [](rtest::State& state) {
+          while (state.keep_running()) {
+             tinystl::list<int> l;
+             for (long long i = 0; i < state.range(); ++i) l.push_back(i);
+             rtest::DoNotOptimize(l.begin().node);
+             rtest::ClobberMemory();
+          }
+       },
+       [](rtest::State& state) {
+          while (state.keep_running()) {
+             std::list<int> l;
+             for (long long i = 0; i < state.range(); ++i) l.push_back(i);
+             rtest::DoNotOptimize(l.front());
+             rtest::ClobberMemory();
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "list/construct_range",
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          while (state.keep_running()) {
+             tinystl::list<int> l(input.data(), input.data() + input.size());
+             rtest::DoNotOptimize(l.begin().node);
+             l.clear();
+             rtest::ClobberMemory();
+          }
+       },
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          while (state.keep_running()) {
+             std::list<int> l(input.begin(), input.end());
+             rtest::DoNotOptimize(l.front());
+             rtest::ClobberMemory();
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "list/iterate",
+       [](rtest::State& state) {
+          tinystl::list<int> l;
+          for (long long i = 0; i < state.range(); ++i) l.push_back(1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       [](rtest::State& state) {
+          std::list<int> l(static_cast<size_t>(state.range()), 1);
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       sizes);
+
+   // after compact() against the same churn left in place
+   rtest::Benchmarker::add_comparison(
+       "list/iterate_churned",
+       [](rtest::State& state) {
+          tinystl::list<int> l;
+          churned_list(l, state.range());
+          l.compact();
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       [](rtest::State& state) {
+          std::list<int> l;
+          churned_list(l, state.range());
+          while (state.keep_running()) {
+             long long sum = 0;
+             for (auto it = l.begin(); it != l.end(); ++it) sum += *it;
+             rtest::DoNotOptimize(sum);
+          }
+       },
+       sizes);
+
+   rtest::Benchmarker::add_comparison(
+       "list/sort",
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          while (state.keep_running()) {
+             tinystl::list<int> l;
+             for (int x : input) l.push_back(x);
+             l.sort(l.begin(), l.end());
+             rtest::ClobberMemory();
+          }
+       },
+       [](rtest::State& state) {
+          std::vector<int> input = random_ints(state.range());
+          while (state.keep_running()) {
+             std::list<int> l(input.begin(), input.end());
+             l.sort();
+             rtest::ClobberMemory();
+          }
+       },
+       sizes);
+}
+}  // namespace bench
+
+int main(int argc, char** argv) {
+   bench::container_bench();
+   rtest::Benchmarker::run(argc, argv);
+   return 0;
+}
@@ -0,0 +1,505 @@
+#ifndef _ALGOBASE_H_
+#define _ALGOBASE_H_
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "simd.h"
+#include "type_traits.h"
+
+// Element-moving and searching algorithms used by the containers.
+//
+// Every algorithm picks its loop from the iterator category, and ranges of
+// plain pointers take the library fast path when _type_traits allows it:
+// memmove for copy and move of trivially assignable types, memset for fill
+// of byte-sized types, memcmp for equal of integral types, memchr for find
+// of chars and the simd.h kernels for find of wider arithmetic types. List
+// iterators get node-aware versions in list.h.
+
+namespace tinystl {
+template <class T>
+inline const T& min(const T& a, const T& b) {
+   return b < a ? b : a;
+}
+
+template <class T>
+inline const T& max(const T& a, const T& b) {
+   return a < b ? b : a;
+}
+
+template <class ForwardIterator1, class ForwardIterator2>
+inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b) {
+   using std::swap;
+   swap(*a, *b);
+}
+
+// _true_type when [first, last) -> result can be a memmove
+template <class InputIterator, class OutputIterator>
+struct __memmove_able {
+   typedef _false_type type;
+};
+template <class T>
+struct __memmove_able<T*, T*> {
+   typedef typename _type_traits<T>::has_trivial_assignment_operator type;
+};
+template <class T>
+struct __memmove_able<const T*, T*> {
+   typedef typename _type_traits<T>::has_trivial_assignment_operator type;
+};
+
+// _true_type when two ranges compare equal exactly when their bytes do
+template <class InputIterator1, class InputIterator2>
+struct __memcmp_able {
+   typedef _false_type type;
+};
+template <class T>
+struct __byte_comparable {
+   typedef typename std::conditional<std::is_integral<T>::value ||
+                                         std::is_pointer<T>::value,
+                                     _true_type, _false_type>::type type;
+};
+template <class T>
+struct __memcmp_able<T*, T*> : __byte_comparable<T> {};
+template <class T>
+struct __memcmp_able<const T*, T*> : __byte_comparable<T> {};
+template <class T>
+struct __memcmp_able<T*, const T*> : __byte_comparable<T> {};
+template <class T>
+struct __memcmp_able<const T*, const T*> : __byte_comparable<T> {};
+
+// _true_type for pointers to trivially assignable single bytes
+template <class Iterator>
+struct __byte_range {
+   typedef _false_type type;
+};
+template <class T>
+struct __byte_range<T*> {
+   typedef typename std::conditional<
+       sizeof(T) == 1 && std::is_integral<T>::value,
+       typename _type_traits<T>::has_trivial_assignment_operator,
+       _false_type>::type type;
+};
+template <class T>
+struct __byte_range<const T*> {
+   typedef typename __byte_range<T*>::type type;
+};
+
+// ---------------------------------------------------------------------------
+// copy, copy_backward, move, move_backward
+
+template <class InputIterator, class OutputIterator>
+inline OutputIterator __copy(InputIterator first, InputIterator last,
+                             OutputIterator result, input_iterator_tag) {
+   for (; first != last; ++first, ++result) *result = *first;
+   return result;
+}
+
+// a counted loop the compiler can unroll
+template <class RandomAccessIterator, class OutputIterator>
+inline OutputIterator __copy(RandomAccessIterator first,
+                             RandomAccessIterator last, OutputIterator result,
+                             random_access_iterator_tag) {
+   typedef typename iterator_traits<RandomAccessIterator>::difference_type
+       Distance;
+   for (Distance n = last - first; n > 0; --n, ++first, ++result)
+      *result = *first;
+   return result;
+}
+
+template <class InputIterator, class OutputIterator>
+inline OutputIterator __copy_aux(InputIterator first, InputIterator last,
+                                 OutputIterator result, _false_type) {
+   return __copy(first, last, result, iterator_category(first));
+}
+
+template <class T, class U>
+inline U* __copy_aux(T* first, T* last, U* result, _true_type) {
+   const std::ptrdiff_t n = last - first;
+   if (n) std::memmove(result, first, sizeof(U) * n);
+   return result + n;
+}
+
+template <class InputIterator, class OutputIterator>
+inline OutputIterator copy(InputIterator first, InputIterator last,
+                           OutputIterator result) {
+   typedef typename __memmove_able<InputIterator, OutputIterator>::type
+       trivial;
+   return __copy_aux(first, last, result, trivial());
+}
+
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2 __copy_backward_aux(BidirectionalIterator1 first,
+                                                  BidirectionalIterator1 last,
+                                                  BidirectionalIterator2 result,
+                                                  _false_type) {
+   while (first != last) *--result = *--last;
+   return result;
+}
+
+template <class T, class U>
+inline U* __copy_backward_aux(T* first, T* last, U* result, _true_type) {
+   const std::ptrdiff_t n = last - first;
+   if (n) std::memmove(result - n, first, sizeof(U) * n);
+   return result - n;
+}
+
+// copy into the range ending at result, from the back
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2 copy_backward(BidirectionalIterator1 first,
+                                            BidirectionalIterator1 last,
+                                            BidirectionalIterator2 result) {
+   typedef typename __memmove_able<BidirectionalIterator1,
+                                   BidirectionalIterator2>::type trivial;
+   return __copy_backward_aux(first, last, result, trivial());
+}
+
+template <class InputIterator, class OutputIterator>
+inline OutputIterator __move_aux(InputIterator first, InputIterator last,
+                                 OutputIterator result, _false_type) {
+   for (; first != last; ++first, ++result) *result = std::move(*first);
+   return result;
+}
+
+template <class T, class U>
+inline U* __move_aux(T* first, T* last, U* result, _true_type) {
+   return __copy_aux(first, last, result, _true_type());
+}
+
+template <class InputIterator, class OutputIterator>
+inline OutputIterator move(InputIterator first, InputIterator last,
+                           OutputIterator result) {
+   typedef typename __memmove_able<InputIterator, OutputIterator>::type
+       trivial;
+   return __move_aux(first, last, result, trivial());
+}
+
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2 __move_backward_aux(BidirectionalIterator1 first,
+                                                  BidirectionalIterator1 last,
+                                                  BidirectionalIterator2 result,
+                                                  _false_type) {
+   while (first != last) *--result = std::move(*--last);
+   return result;
+}
+
+template <class T, class U>
+inline U* __move_backward_aux(T* first, T* last, U* result, _true_type) {
+   return __copy_backward_aux(first, last, result, _true_type());
+}
+
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2 move_backward(BidirectionalIterator1 first,
+                                            BidirectionalIterator1 last,
+                                            BidirectionalIterator2 result) {
+   typedef typename __memmove_able<BidirectionalIterator1,
+                                   BidirectionalIterator2>::type trivial;
+   return __move_backward_aux(first, last, result, trivial());
+}
+
+// ---------------------------------------------------------------------------
+// fill, fill_n
+
+template <class ForwardIterator, class T>
+inline void __fill(ForwardIterator first, ForwardIterator last, const T& value,
+                   forward_iterator_tag) {
+   for (; first != last; ++first) *first = value;
+}
+
+template <class RandomAccessIterator, class T>
+inline void __fill(RandomAccessIterator first, RandomAccessIterator last,
+                   const T& value, random_access_iterator_tag) {
+   typedef typename iterator_traits<RandomAccessIterator>::difference_type
+       Distance;
+   for (Distance n = last - first; n > 0; --n, ++first) *first = value;
+}
+
+template <class ForwardIterator, class T>
+inline void __fill_aux(ForwardIterator first, ForwardIterator last,
+                       const T& value, _false_type) {
+   __fill(first, last, value, iterator_category(first));
+}
+
+template <class U, class T>
+inline void __fill_aux(U* first, U* last, const T& value, _true_type) {
+   const U byte = value;
+   if (last != first) std::memset(first, static_cast<unsigned char>(byte),
+                                  last - first);
+}
+
+template <class ForwardIterator, class T>
+inline void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+   typedef typename __byte_range<ForwardIterator>::type bytes;
+   __fill_aux(first, last, value, bytes());
+}
+
+template <class OutputIterator, class Size, class T>
+inline OutputIterator __fill_n_aux(OutputIterator first, Size n,
+                                   const T& value, _false_type) {
+   for (; n > 0; --n, ++first) *first = value;
+   return first;
+}
+
+template <class U, class Size, class T>
+inline U* __fill_n_aux(U* first, Size n, const T& value, _true_type) {
+   if (n <= 0) return first;
+   __fill_aux(first, first + n, value, _true_type());
+   return first + n;
+}
+
+template <class OutputIterator, class Size, class T>
+inline OutputIterator fill_n(OutputIterator first, Size n, const T& value) {
+   typedef typename __byte_range<OutputIterator>::type bytes;
+   return __fill_n_aux(first, n, value, bytes());
+}
+
+// ---------------------------------------------------------------------------
+// equal, find
+
+template <class InputIterator1, class InputIterator2>
+inline bool __equal_aux(InputIterator1 first1, InputIterator1 last1,
+                        InputIterator2 first2, _false_type) {
+   for (; first1 != last1; ++first1, ++first2) {
+      if (!(*first1 == *first2)) return false;
+   }
+   return true;
+}
+
+template <class T, class U>
+inline bool __equal_aux(T* first1, T* last1, U* first2, _true_type) {
+   return std::memcmp(first1, first2, sizeof(T) * (last1 - first1)) == 0;
+}
+
+template <class InputIterator1, class InputIterator2>
+inline bool equal(InputIterator1 first1, InputIterator1 last1,
+                  InputIterator2 first2) {
+   typedef typename __memcmp_able<InputIterator1, InputIterator2>::type bytes;
+   return __equal_aux(first1, last1, first2, bytes());
+}
+
+template <class InputIterator, class T>
+inline InputIterator __find(InputIterator first, InputIterator last,
+                            const T& value, input_iterator_tag) {
+   while (first != last && !(*first == value)) ++first;
+   return first;
+}
+
+// unrolled by four
+template <class RandomAccessIterator, class T>
+RandomAccessIterator __find(RandomAccessIterator first,
+                            RandomAccessIterator last, const T& value,
+                            random_access_iterator_tag) {
+   typedef typename iterator_traits<RandomAccessIterator>::difference_type
+       Distance;
+   for (Distance trip = (last - first) >> 2; trip > 0; --trip) {
+      if (*first == value) return first;
+      ++first;
+      if (*first == value) return first;
+      ++first;
+      if (*first == value) return first;
+      ++first;
+      if (*first == value) return first;
+      ++first;
+   }
+   switch (last - first) {
+      case 3:
+         if (*first == value) return first;
+         ++first;
+         // fall through
+      case 2:
+         if (*first == value) return first;
+         ++first;
+         // fall through
+      case 1:
+         if (*first == value) return first;
+         ++first;
+         // fall through
+      default:
+         return last;
+   }
+}
+
+template <class InputIterator, class T>
+inline InputIterator __find_simd_aux(InputIterator first, InputIterator last,
+                                     const T& value, _false_type) {
+   return __find(first, last, value, iterator_category(first));
+}
+
+template <class U, class T>
+inline U* __find_simd_aux(U* first, U* last, const T& value, _true_type) {
+   typedef typename std::remove_const<U>::type V;
+   return const_cast<U*>(__simd_find<V>(first, last, static_cast<V>(value)));
+}
+
+template <class InputIterator, class T>
+inline InputIterator __find_aux(InputIterator first, InputIterator last,
+                                const T& value, _false_type) {
+   typedef typename __simd_range<InputIterator, T>::type vectorized;
+   return __find_simd_aux(first, last, value, vectorized());
+}
+
+template <class U, class T>
+inline U* __find_aux(U* first, U* last, const T& value, _true_type) {
+   const U byte = value;
+   // a value no U can hold is never found
+   if (!(byte == value) || first == last) return last;
+   const void* p =
+       std::memchr(first, static_cast<unsigned char>(byte), last - first);
+   return p ? static_cast<U*>(const_cast<void*>(p)) : last;
+}
+
+template <class InputIterator, class T>
+inline InputIterator find(InputIterator first, InputIterator last,
+                          const T& value) {
+   typedef typename __byte_range<InputIterator>::type bytes;
+   return __find_aux(first, last, value, bytes());
+}
+
+template <class InputIterator, class Predicate>
+inline InputIterator find_if(InputIterator first, InputIterator last,
+                             Predicate pred) {
+   while (first != last && !pred(*first)) ++first;
+   return first;
+}
+
+// ---------------------------------------------------------------------------
+// lower_bound, upper_bound
+
+// advance is O(1) for random access, so one loop serves every category
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                            const T& value, Compare comp) {
+   typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+   Distance len = tinystl::distance(first, last);
+   while (len > 0) {
+      Distance half = len >> 1;
+      ForwardIterator middle = first;
+      tinystl::advance(middle, half);
+      if (comp(*middle, value)) {
+         first = ++middle;
+         len = len - half - 1;
+      } else {
+         len = half;
+      }
+   }
+   return first;
+}
+
+template <class ForwardIterator, class T>
+inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                   const T& value) {
+   return tinystl::lower_bound(
+       first, last, value, [](const typename iterator_traits<
+                                  ForwardIterator>::value_type& a,
+                              const T& b) { return a < b; });
+}
+
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                            const T& value, Compare comp) {
+   typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+   Distance len = tinystl::distance(first, last);
+   while (len > 0) {
+      Distance half = len >> 1;
+      ForwardIterator middle = first;
+      tinystl::advance(middle, half);
+      if (comp(value, *middle)) {
+         len = half;
+      } else {
+         first = ++middle;
+         len = len - half - 1;
+      }
+   }
+   return first;
+}
+
+template <class ForwardIterator, class T>
+inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                   const T& value) {
+   return tinystl::upper_bound(
+       first, last, value,
+       [](const T& a, const typename iterator_traits<
+                          ForwardIterator>::value_type& b) { return a < b; });
+}
+
+// ---------------------------------------------------------------------------
+// reverse, rotate
+
+template <class BidirectionalIterator>
+inline void __reverse(BidirectionalIterator first, BidirectionalIterator last,
+                      bidirectional_iterator_tag) {
+   while (first != last && first != --last) {
+      tinystl::iter_swap(first, last);
+      ++first;
+   }
+}
+
+template <class RandomAccessIterator>
+inline void __reverse(RandomAccessIterator first, RandomAccessIterator last,
+                      random_access_iterator_tag) {
+   if (first == last) return;
+   for (--last; first < last; ++first, --last) tinystl::iter_swap(first, last);
+}
+
+template <class BidirectionalIterator>
+inline void reverse(BidirectionalIterator first, BidirectionalIterator last) {
+   __reverse(first, last, iterator_category(first));
+}
+
+template <class ForwardIterator>
+ForwardIterator __rotate(ForwardIterator first, ForwardIterator middle,
+                         ForwardIterator last, forward_iterator_tag) {
+   ForwardIterator first2 = middle;
+   do {
+      tinystl::iter_swap(first, first2);
+      ++first;
+      ++first2;
+      if (first == middle) middle = first2;
+   } while (first2 != last);
+
+   ForwardIterator result = first;
+   first2 = middle;
+   while (first2 != last) {
+      tinystl::iter_swap(first, first2);
+      ++first;
+      ++first2;
+      if (first == middle)
+         middle = first2;
+      else if (first2 == last)
+         first2 = middle;
+   }
+   return result;
+}
+
+// three reversals, the last one folded into finding the result
+template <class BidirectionalIterator>
+BidirectionalIterator __rotate(BidirectionalIterator first,
+                               BidirectionalIterator middle,
+                               BidirectionalIterator last,
+                               bidirectional_iterator_tag) {
+   tinystl::reverse(first, middle);
+   tinystl::reverse(middle, last);
+   while (first != middle && middle != last) {
+      tinystl::iter_swap(first, --last);
+      ++first;
+   }
+   if (first == middle) {
+      tinystl::reverse(middle, last);
+      return last;
+   }
+   tinystl::reverse(first, middle);
+   return first;
+}
+
+// returns the new position of *first
+template <class ForwardIterator>
+inline ForwardIterator rotate(ForwardIterator first, ForwardIterator middle,
+                              ForwardIterator last) {
+   if (first == middle) return last;
+   if (middle == last) return first;
+   return __rotate(first, middle, last, iterator_category(first));
+}
+}  // namespace tinystl
+
+#endif
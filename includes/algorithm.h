@@ -0,0 +1,509 @@
+#ifndef _ALGORITHM_H_
+#define _ALGORITHM_H_
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "simd.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+
+namespace tinystl {
+enum { __stl_threshold = 16 };
+// below this size the histogram passes cost more than a comparison sort
+enum { __radix_threshold = 256 };
+
+// map an arithmetic key to an unsigned integer with the same ordering
+template <class T, bool is_float = std::is_floating_point<T>::value>
+struct __radix_key {
+   typedef typename std::make_unsigned<T>::type type;
+   static type encode(T x) {
+      // flip the sign bit so that negative values come first
+      const type sign = std::is_signed<T>::value
+                            ? static_cast<type>(type(1) << (sizeof(T) * 8 - 1))
+                            : type(0);
+      return static_cast<type>(static_cast<type>(x) ^ sign);
+   }
+};
+
+template <class T>
+struct __radix_key<T, true> {
+   static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                 "only 32 and 64-bit floating point keys are radix sorted");
+   typedef typename std::conditional<sizeof(T) == 4, unsigned int,
+                                     unsigned long long>::type type;
+   static type encode(T x) {
+      type bits;
+      std::memcpy(&bits, &x, sizeof(T));
+      const type sign = type(1) << (sizeof(T) * 8 - 1);
+      // negative floats: reverse the order of all bits
+      // positive floats: move them above the negative ones
+      return (bits & sign) ? ~bits : (bits | sign);
+   }
+};
+
+// integral (except bool) and 32/64-bit floating point types are radix sorted
+template <class T>
+struct __is_radix_key {
+   typedef typename std::conditional<
+       (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+           (std::is_floating_point<T>::value &&
+            (sizeof(T) == 4 || sizeof(T) == 8)),
+       _true_type, _false_type>::type type;
+};
+
+template <class T>
+struct __identity_key {
+   const T& operator()(const T& x) const { return x; }
+};
+
+// compare two elements by their keys, for keys that are not radix sorted
+template <class KeyOf>
+struct __key_compare {
+   KeyOf key_of;
+   explicit __key_compare(KeyOf k) : key_of(k) {}
+   template <class T>
+   bool operator()(const T& x, const T& y) const {
+      return key_of(x) < key_of(y);
+   }
+};
+
+// compare two elements by their encoded keys, used for small ranges
+template <class KeyOf, class Key>
+struct __key_less {
+   KeyOf key_of;
+   explicit __key_less(KeyOf k) : key_of(k) {}
+   template <class T>
+   bool operator()(const T& x, const T& y) const {
+      return __radix_key<Key>::encode(key_of(x)) <
+             __radix_key<Key>::encode(key_of(y));
+   }
+};
+
+// ---------------------------------------------------------------------------
+// introsort: quicksort with median-of-3 pivot, heapsort when the recursion
+// gets too deep, and a final insertion sort over the nearly sorted range
+
+template <class Size>
+inline Size __lg(Size n) {
+   Size k;
+   for (k = 0; n > 1; n >>= 1) ++k;
+   return k;
+}
+
+template <class T, class Compare>
+inline const T& __median(const T& a, const T& b, const T& c, Compare comp) {
+   if (comp(a, b)) {
+      if (comp(b, c)) return b;
+      if (comp(a, c)) return c;
+      return a;
+   }
+   if (comp(a, c)) return a;
+   if (comp(b, c)) return c;
+   return b;
+}
+
+template <class RandomAccessIterator, class Distance, class T, class Compare>
+void __sift_down(RandomAccessIterator first, Distance hole, Distance len,
+                 T value, Compare comp) {
+   const Distance top = hole;
+   Distance child = 2 * hole + 2;
+   while (child < len) {
+      if (comp(*(first + child), *(first + (child - 1)))) --child;
+      *(first + hole) = *(first + child);
+      hole = child;
+      child = 2 * child + 2;
+   }
+   if (child == len) {
+      *(first + hole) = *(first + (child - 1));
+      hole = child - 1;
+   }
+   // push value back up from the leaf
+   Distance parent = (hole - 1) / 2;
+   while (hole > top && comp(*(first + parent), value)) {
+      *(first + hole) = *(first + parent);
+      hole = parent;
+      parent = (hole - 1) / 2;
+   }
+   *(first + hole) = value;
+}
+
+template <class RandomAccessIterator, class T, class Distance, class Compare>
+void __heap_sort(RandomAccessIterator first, RandomAccessIterator last, T*,
+                 Distance*, Compare comp) {
+   Distance len = last - first;
+   if (len < 2) return;
+   for (Distance parent = (len - 2) / 2;; --parent) {
+      __sift_down(first, parent, len, T(*(first + parent)), comp);
+      if (parent == 0) break;
+   }
+   while (len > 1) {
+      --len;
+      T value = *(first + len);
+      *(first + len) = *first;
+      __sift_down(first, Distance(0), len, value, comp);
+   }
+}
+
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator __unguarded_partition(RandomAccessIterator first,
+                                           RandomAccessIterator last,
+                                           T pivot, Compare comp) {
+   for (;;) {
+      while (comp(*first, pivot)) ++first;
+      --last;
+      while (comp(pivot, *last)) --last;
+      if (!(first < last)) return first;
+      tinystl::iter_swap(first, last);
+      ++first;
+   }
+}
+
+template <class RandomAccessIterator, class T, class Size, class Compare>
+void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last,
+                      T*, Size depth_limit, Compare comp) {
+   while (last - first > __stl_threshold) {
+      if (depth_limit == 0) {
+         __heap_sort(first, last, static_cast<T*>(0), distance_type(first),
+                     comp);
+         return;
+      }
+      --depth_limit;
+      RandomAccessIterator cut = __unguarded_partition(
+          first, last,
+          T(__median(*first, *(first + (last - first) / 2), *(last - 1),
+                     comp)),
+          comp);
+      __introsort_loop(cut, last, static_cast<T*>(0), depth_limit, comp);
+      last = cut;
+   }
+}
+
+template <class RandomAccessIterator, class T, class Compare>
+void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                      T*, Compare comp) {
+   if (first == last) return;
+   for (RandomAccessIterator i = first + 1; i != last; ++i) {
+      T value = *i;
+      RandomAccessIterator hole = i;
+      if (comp(value, *first)) {
+         // smaller than the head, shift the whole prefix
+         for (; hole != first; --hole) *hole = *(hole - 1);
+      } else {
+         for (RandomAccessIterator prev = hole - 1; comp(value, *prev);
+              --prev, --hole) {
+            *hole = *prev;
+         }
+      }
+      *hole = value;
+   }
+}
+
+template <class RandomAccessIterator, class Compare>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare comp) {
+   if (last - first < 2) return;
+   __introsort_loop(first, last, value_type(first), __lg(last - first) * 2,
+                    comp);
+   __insertion_sort(first, last, value_type(first), comp);
+}
+
+// ---------------------------------------------------------------------------
+// stable merge sort: insertion sorted runs of __stl_threshold, then merge
+// passes that ping-pong between the range and a buffer
+
+// merge the neighbouring runs of width elements in [first, last) into out,
+// ties are taken from the left run
+template <class InputIterator, class OutputIterator, class Compare>
+void __merge_pass(InputIterator first, InputIterator last, OutputIterator out,
+                  size_t width, Compare comp) {
+   const size_t n = static_cast<size_t>(last - first);
+   for (size_t lo = 0; lo < n; lo += 2 * width) {
+      const size_t mid = lo + width < n ? lo + width : n;
+      const size_t hi = mid + width < n ? mid + width : n;
+      InputIterator a = first + lo, a_end = first + mid;
+      InputIterator b = a_end, b_end = first + hi;
+      for (; a != a_end && b != b_end; ++out) {
+         if (comp(*b, *a)) {
+            *out = *b;
+            ++b;
+         } else {
+            *out = *a;
+            ++a;
+         }
+      }
+      out = tinystl::copy(a, a_end, out);
+      out = tinystl::copy(b, b_end, out);
+   }
+}
+
+template <class RandomAccessIterator, class T, class Compare>
+void __stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                   T*, Compare comp) {
+   typedef simple_alloc<T, alloc> buffer_allocator;
+   const size_t n = static_cast<size_t>(last - first);
+   for (size_t lo = 0; lo < n; lo += __stl_threshold) {
+      const size_t hi = lo + __stl_threshold < n ? lo + __stl_threshold : n;
+      __insertion_sort(first + lo, first + hi, static_cast<T*>(0), comp);
+   }
+   if (n <= __stl_threshold) return;
+
+   T* buffer = buffer_allocator::allocate(n);
+   tinystl::uninitialized_copy(first, last, buffer);
+   bool in_buffer = false;
+   for (size_t width = __stl_threshold; width < n; width *= 2) {
+      if (in_buffer) {
+         __merge_pass(buffer, buffer + n, first, width, comp);
+      } else {
+         __merge_pass(first, last, buffer, width, comp);
+      }
+      in_buffer = !in_buffer;
+   }
+   if (in_buffer) tinystl::copy(buffer, buffer + n, first);
+   tinystl::destroy(buffer, buffer + n);
+   buffer_allocator::deallocate(buffer, n);
+}
+
+// ---------------------------------------------------------------------------
+// LSD radix sort, one byte per pass, stable
+// the scratch buffer comes from the allocator and is ping-ponged with the
+// input range; passes in which every key shares the same byte are skipped
+
+template <class RandomAccessIterator, class T, class KeyOf>
+void __radix_sort(RandomAccessIterator first, RandomAccessIterator last, T*,
+                  KeyOf key_of) {
+   typedef typename std::decay<decltype(key_of(*first))>::type key_type;
+   typedef __radix_key<key_type> radix_key;
+   typedef typename radix_key::type ukey;
+   typedef simple_alloc<T, alloc> buffer_allocator;
+   enum { passes = sizeof(ukey) };
+
+   const size_t n = static_cast<size_t>(last - first);
+   if (n < __radix_threshold) {
+      // insertion sort keeps equal keys in order, introsort would not
+      __insertion_sort(first, last, static_cast<T*>(0),
+                       __key_less<KeyOf, key_type>(key_of));
+      return;
+   }
+
+   // one read pass builds the histograms of every byte
+   size_t count[passes][256];
+   std::memset(count, 0, sizeof(count));
+   for (RandomAccessIterator it = first; it != last; ++it) {
+      ukey k = radix_key::encode(key_of(*it));
+      for (int p = 0; p < passes; ++p) ++count[p][(k >> (8 * p)) & 0xff];
+   }
+
+   T* buffer = buffer_allocator::allocate(n);
+   tinystl::uninitialized_copy(first, last, buffer);
+   bool in_buffer = false;
+   for (int p = 0; p < passes; ++p) {
+      const int shift = 8 * p;
+      size_t* bucket = count[p];
+      const ukey probe =
+          radix_key::encode(key_of(in_buffer ? *buffer : *first));
+      if (bucket[(probe >> shift) & 0xff] == n) continue;
+
+      size_t sum = 0;
+      for (int d = 0; d < 256; ++d) {
+         size_t c = bucket[d];
+         bucket[d] = sum;
+         sum += c;
+      }
+      if (in_buffer) {
+         for (T* cur = buffer; cur != buffer + n; ++cur) {
+            ukey k = radix_key::encode(key_of(*cur));
+            *(first + bucket[(k >> shift) & 0xff]++) = *cur;
+         }
+      } else {
+         for (RandomAccessIterator cur = first; cur != last; ++cur) {
+            ukey k = radix_key::encode(key_of(*cur));
+            buffer[bucket[(k >> shift) & 0xff]++] = *cur;
+         }
+      }
+      in_buffer = !in_buffer;
+   }
+   if (in_buffer) tinystl::copy(buffer, buffer + n, first);
+   tinystl::destroy(buffer, buffer + n);
+   buffer_allocator::deallocate(buffer, n);
+}
+
+template <class RandomAccessIterator, class T>
+inline void __sort_aux(RandomAccessIterator first, RandomAccessIterator last,
+                       T*, _true_type) {
+   __radix_sort(first, last, static_cast<T*>(0), __identity_key<T>());
+}
+
+template <class RandomAccessIterator, class T>
+inline void __sort_aux(RandomAccessIterator first, RandomAccessIterator last,
+                       T*, _false_type) {
+   tinystl::sort(first, last, std::less<T>());
+}
+
+template <class RandomAccessIterator, class T>
+inline void __sort(RandomAccessIterator first, RandomAccessIterator last,
+                   T*) {
+   typedef typename __is_radix_key<T>::type is_radix_key;
+   __sort_aux(first, last, static_cast<T*>(0), is_radix_key());
+}
+
+// arithmetic value types are radix sorted, everything else uses introsort
+template <class RandomAccessIterator>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last) {
+   __sort(first, last, value_type(first));
+}
+
+template <class RandomAccessIterator, class T, class KeyOf>
+inline void __sort_by_key_aux(RandomAccessIterator first,
+                              RandomAccessIterator last, T*, KeyOf key_of,
+                              _true_type) {
+   __radix_sort(first, last, static_cast<T*>(0), key_of);
+}
+
+template <class RandomAccessIterator, class T, class KeyOf>
+inline void __sort_by_key_aux(RandomAccessIterator first,
+                              RandomAccessIterator last, T*, KeyOf key_of,
+                              _false_type) {
+   __stable_sort(first, last, static_cast<T*>(0),
+                 __key_compare<KeyOf>(key_of));
+}
+
+// stable sort of records by a key, e.g.
+// sort_by_key(v.begin(), v.end(), [](const Rec& r) { return r.id; });
+// keys accepted by __is_radix_key are radix sorted, others (long double,
+// strings) are merge sorted with operator<
+template <class RandomAccessIterator, class KeyOf>
+inline void sort_by_key(RandomAccessIterator first, RandomAccessIterator last,
+                        KeyOf key_of) {
+   typedef typename std::decay<decltype(key_of(*first))>::type key_type;
+   typedef typename __is_radix_key<key_type>::type is_radix_key;
+   __sort_by_key_aux(first, last, value_type(first), key_of, is_radix_key());
+}
+
+// ---------------------------------------------------------------------------
+// scans: count, contains, any_of, minmax_element, accumulate
+//
+// Pointer ranges of 4 and 8 byte arithmetic types run the simd.h kernels.
+
+template <class InputIterator, class T>
+inline typename iterator_traits<InputIterator>::difference_type __count_aux(
+    InputIterator first, InputIterator last, const T& value, _false_type) {
+   typename iterator_traits<InputIterator>::difference_type n = 0;
+   for (; first != last; ++first) {
+      if (*first == value) ++n;
+   }
+   return n;
+}
+
+template <class U, class T>
+inline std::ptrdiff_t __count_aux(U* first, U* last, const T& value,
+                                  _true_type) {
+   typedef typename std::remove_const<U>::type V;
+   return __simd_count<V>(first, last, static_cast<V>(value));
+}
+
+template <class InputIterator, class T>
+inline typename iterator_traits<InputIterator>::difference_type count(
+    InputIterator first, InputIterator last, const T& value) {
+   typedef typename __simd_range<InputIterator, T>::type vectorized;
+   return __count_aux(first, last, value, vectorized());
+}
+
+template <class InputIterator, class T>
+inline bool contains(InputIterator first, InputIterator last,
+                     const T& value) {
+   return tinystl::find(first, last, value) != last;
+}
+
+template <class InputIterator, class Predicate>
+inline bool any_of(InputIterator first, InputIterator last, Predicate pred) {
+   return tinystl::find_if(first, last, pred) != last;
+}
+
+template <class InputIterator, class Predicate>
+inline bool none_of(InputIterator first, InputIterator last, Predicate pred) {
+   return tinystl::find_if(first, last, pred) == last;
+}
+
+template <class InputIterator, class Predicate>
+inline bool all_of(InputIterator first, InputIterator last, Predicate pred) {
+   for (; first != last; ++first) {
+      if (!pred(*first)) return false;
+   }
+   return true;
+}
+
+// the first smallest and the last largest element, as std::minmax_element
+template <class ForwardIterator, class Compare>
+std::pair<ForwardIterator, ForwardIterator> minmax_element(
+    ForwardIterator first, ForwardIterator last, Compare comp) {
+   std::pair<ForwardIterator, ForwardIterator> result(first, first);
+   if (first == last) return result;
+   while (++first != last) {
+      if (comp(*first, *result.first)) result.first = first;
+      if (!comp(*first, *result.second)) result.second = first;
+   }
+   return result;
+}
+
+template <class ForwardIterator>
+inline std::pair<ForwardIterator, ForwardIterator> __minmax_element_aux(
+    ForwardIterator first, ForwardIterator last, _false_type) {
+   typedef typename iterator_traits<ForwardIterator>::value_type T;
+   return tinystl::minmax_element(first, last, std::less<T>());
+}
+
+template <class U>
+inline std::pair<U*, U*> __minmax_element_aux(U* first, U* last,
+                                              _true_type) {
+   if (first == last) return std::pair<U*, U*>(last, last);
+   std::pair<const U*, const U*> result = __simd_minmax(
+       const_cast<const U*>(first), const_cast<const U*>(last));
+   return std::pair<U*, U*>(const_cast<U*>(result.first),
+                            const_cast<U*>(result.second));
+}
+
+template <class ForwardIterator>
+inline std::pair<ForwardIterator, ForwardIterator> minmax_element(
+    ForwardIterator first, ForwardIterator last) {
+   typedef typename __simd_pointer<ForwardIterator>::type vectorized;
+   return __minmax_element_aux(first, last, vectorized());
+}
+
+template <class InputIterator, class T, class BinaryOperation>
+inline T accumulate(InputIterator first, InputIterator last, T init,
+                    BinaryOperation op) {
+   for (; first != last; ++first) init = op(init, *first);
+   return init;
+}
+
+template <class InputIterator, class T>
+inline T __accumulate_aux(InputIterator first, InputIterator last, T init,
+                          _false_type) {
+   for (; first != last; ++first) init = init + *first;
+   return init;
+}
+
+template <class U, class T>
+inline T __accumulate_aux(U* first, U* last, T init, _true_type) {
+   return __simd_sum<T>(first, last, init);
+}
+
+// vectorized when init has the element type, floating point sums are then
+// added in a different order than a left fold
+template <class InputIterator, class T>
+inline T accumulate(InputIterator first, InputIterator last, T init) {
+   typedef typename std::conditional<
+       std::is_same<typename iterator_traits<InputIterator>::value_type,
+                    T>::value,
+       typename __simd_pointer<InputIterator>::type, _false_type>::type
+       vectorized;
+   return __accumulate_aux(first, last, init, vectorized());
+}
+}  // namespace tinystl
+
+#endif
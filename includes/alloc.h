@@ -2,6 +2,7 @@
 #define _ALLOC_H_
 #include <cassert>
 #include <cstdlib>
+#include <mutex>
 
 #if 0
 #include <new>
@@ -30,6 +31,25 @@ class __malloc_alloc_template {
    }
    static void deallocate(void* p, size_t) { std::free(p); }
 
+   // count blocks linked through their first word, as __default_alloc_template
+   static void* allocate_n(size_t n, size_t count) {
+      if (n < sizeof(void*)) n = sizeof(void*);
+      void* head = 0;
+      for (; count > 0; --count) {
+         void* p = allocate(n);
+         *reinterpret_cast<void**>(p) = head;
+         head = p;
+      }
+      return head;
+   }
+   static void deallocate_n(void* p, size_t, size_t count) {
+      for (; count > 0; --count) {
+         void* next = *reinterpret_cast<void**>(p);
+         std::free(p);
+         p = next;
+      }
+   }
+
    static void* reallocate(void* p, size_t, size_t new_sz) {
       void* result = std::realloc(p, new_sz);
       if (0 == result) result = oom_realloc(p, new_sz);
@@ -82,9 +102,62 @@ typedef __malloc_alloc_template<0> malloc_alloc;
 
 enum { __ALIGN = 8 };
 enum { __MAX_BYTES = 128 };
-enum { __NFREELISTS = __MAX_BYTES / __ALIGN };
 
-template <bool threads, int inst>
+// the smallest class that fits each multiple of __ALIGN up to N - 1 of them
+template <size_t N>
+struct __size_class_table {
+   unsigned char index[N];
+};
+
+template <size_t N>
+constexpr __size_class_table<N> __make_size_class_table(const size_t* sizes) {
+   __size_class_table<N> t = {};
+   size_t c = 0;
+   for (size_t i = 0; i < N; ++i) {
+      while (sizes[c] < i * __ALIGN) ++c;
+      t.index[i] = static_cast<unsigned char>(c);
+   }
+   return t;
+}
+
+constexpr bool __valid_size_classes(const size_t* sizes, size_t count) {
+   if (count == 0 || count > 255 || sizes[0] < sizeof(void*)) return false;
+   for (size_t i = 0; i < count; ++i) {
+      if (sizes[i] % __ALIGN != 0) return false;
+      if (i > 0 && sizes[i] <= sizes[i - 1]) return false;
+   }
+   return true;
+}
+
+// A size class layout for __default_alloc_template, fixed at compile time:
+// the ascending block sizes of its free lists, each a multiple of __ALIGN.
+// A request is served from the smallest class it fits through a constexpr
+// lookup table, requests above the last class go to malloc_alloc.
+template <size_t... Sizes>
+struct size_classes {
+   enum { count = sizeof...(Sizes) };
+   static constexpr size_t sizes[count] = {Sizes...};
+   static constexpr size_t max_bytes = sizes[count - 1];
+   static_assert(__valid_size_classes(sizes, count),
+                 "size classes must ascend in multiples of __ALIGN");
+
+   static constexpr __size_class_table<max_bytes / __ALIGN + 1> table =
+       __make_size_class_table<max_bytes / __ALIGN + 1>(sizes);
+
+   // bytes must be in (0, max_bytes]
+   static constexpr size_t index(size_t bytes) {
+      return table.index[(bytes + __ALIGN - 1) / __ALIGN];
+   }
+   static constexpr size_t round_up(size_t bytes) {
+      return sizes[index(bytes)];
+   }
+};
+
+// 8 byte steps up to 64, then 16 byte steps up to __MAX_BYTES
+typedef size_classes<8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128>
+    __default_size_classes;
+
+template <bool threads, int inst, class SizeClasses = __default_size_classes>
 class __default_alloc_template {
   private:
    // raise bytes to the multiple of 8
@@ -99,12 +172,11 @@ class __default_alloc_template {
    };
 
   private:
-   // 16 free lists
-   // block size: 8,16,24,32,40,48,56,64,72,80,88,96,104,112,120,128 bytes
-   static obj* volatile free_list[__NFREELISTS];
+   // one free list per size class
+   static obj* volatile free_list[SizeClasses::count];
    // according to bytes, determine which free-list to use
    static size_t FREELIST_INDEX(size_t bytes) {
-      return (((bytes) + __ALIGN - 1) / __ALIGN - 1);
+      return SizeClasses::index(bytes);
    }
    // return a obj of size n, and add other chunks of size n to free-list
    static void* refill(size_t n);
@@ -112,6 +184,20 @@ class __default_alloc_template {
    // if it is not possible, nobjs may decrese
    static char* chunk_alloc(size_t n, int& nobjs);
 
+   // Refill batches adapt per class. A class that runs dry again before
+   // every class could have refilled once is hot and doubles its batch, a
+   // class that waited more than four such rounds is cold and halves it.
+   enum {
+      initial_batch = 20,
+      min_batch = 4,
+      max_batch = 512,
+      max_batch_bytes = 16384
+   };
+   static int batch[SizeClasses::count];
+   static size_t last_refill[SizeClasses::count];  // refill_clock then
+   static size_t refill_clock;
+   static int refill_batch(size_t i, size_t n);
+
    // chunk allocation state
    static char* start_free;  // the start of the memory pool, only be changed in
                              // chunck_alloc()
@@ -119,40 +205,80 @@ class __default_alloc_template {
                              // chunck_alloc()
    static size_t heap_size;
 
+   // guards the free lists and the memory pool when threads is true
+   static std::mutex pool_mutex;
+   class lock {
+     public:
+      lock() {
+         if (threads) pool_mutex.lock();
+      }
+      ~lock() {
+         if (threads) pool_mutex.unlock();
+      }
+   };
+
   public:
    static void* allocate(size_t n);
    static void deallocate(void* p, size_t n);
    static void* reallocate(void* p, size_t old_sz, size_t new_sz);
+
+   // count blocks of n bytes under one lock, linked through their first
+   // word and ending in 0. The free list is drained first and the rest is
+   // carved side by side from the pool. Each block can be given back on
+   // its own with deallocate(p, n).
+   static void* allocate_n(size_t n, size_t count);
+   // give back count blocks linked as allocate_n returns them
+   static void deallocate_n(void* p, size_t n, size_t count);
+
+   // the objects the last refill of the class of n asked for
+   static int refill_batch_size(size_t n) {
+      lock guard;
+      const size_t i = FREELIST_INDEX(n);
+      return batch[i] != 0 ? batch[i] : static_cast<int>(initial_batch);
+   }
 };
-template <bool threads, int inst>
-char* __default_alloc_template<threads, inst>::start_free = 0;
+template <bool threads, int inst, class SizeClasses>
+char* __default_alloc_template<threads, inst, SizeClasses>::start_free = 0;
 
-template <bool threads, int inst>
-char* __default_alloc_template<threads, inst>::end_free = 0;
+template <bool threads, int inst, class SizeClasses>
+char* __default_alloc_template<threads, inst, SizeClasses>::end_free = 0;
 
-template <bool threads, int inst>
-size_t __default_alloc_template<threads, inst>::heap_size = 0;
+template <bool threads, int inst, class SizeClasses>
+size_t __default_alloc_template<threads, inst, SizeClasses>::heap_size = 0;
 
-template <bool threads, int inst>
-typename __default_alloc_template<threads, inst>::
-    obj* volatile __default_alloc_template<threads,
-                                           inst>::free_list[__NFREELISTS] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-};
+template <bool threads, int inst, class SizeClasses>
+std::mutex __default_alloc_template<threads, inst, SizeClasses>::pool_mutex;
+
+template <bool threads, int inst, class SizeClasses>
+typename __default_alloc_template<threads, inst, SizeClasses>::obj* volatile
+    __default_alloc_template<threads, inst,
+                             SizeClasses>::free_list[SizeClasses::count];
+
+template <bool threads, int inst, class SizeClasses>
+int __default_alloc_template<threads, inst,
+                             SizeClasses>::batch[SizeClasses::count];
+
+template <bool threads, int inst, class SizeClasses>
+size_t __default_alloc_template<threads, inst,
+                                SizeClasses>::last_refill[SizeClasses::count];
+
+template <bool threads, int inst, class SizeClasses>
+size_t __default_alloc_template<threads, inst, SizeClasses>::refill_clock = 0;
 
 // allocate space from free-list[FREELIST_INDEX(n)]
-template <bool threads, int inst>
-void* __default_alloc_template<threads, inst>::allocate(size_t n) {
+template <bool threads, int inst, class SizeClasses>
+void* __default_alloc_template<threads, inst, SizeClasses>::allocate(size_t n) {
    assert(n > 0);
    obj* volatile* my_free_list;
    obj* result;
-   if (n > static_cast<size_t>(__MAX_BYTES)) {
+   if (n > SizeClasses::max_bytes) {
       return (malloc_alloc::allocate(n));
    }
+   lock guard;
    my_free_list = free_list + FREELIST_INDEX(n);
    result = *my_free_list;
    if (result == 0) {
-      void* r = refill(ROUND_UP(n));
+      void* r = refill(SizeClasses::round_up(n));
       return r;
    }
    *my_free_list = result->free_list_link;
@@ -160,23 +286,110 @@ void* __default_alloc_template<threads, inst>::allocate(size_t n) {
 }
 
 // return the space to free-list
-template <bool threads, int inst>
-void __default_alloc_template<threads, inst>::deallocate(void* p, size_t n) {
+template <bool threads, int inst, class SizeClasses>
+void __default_alloc_template<threads, inst, SizeClasses>::deallocate(
+    void* p, size_t n) {
    obj* q = reinterpret_cast<obj*>(p);
    obj* volatile* my_free_list;
 
-   if (n > static_cast<size_t>(__MAX_BYTES)) {
+   if (n > SizeClasses::max_bytes) {
       malloc_alloc::deallocate(p, n);
       return;
    }
+   lock guard;
    my_free_list = free_list + FREELIST_INDEX(n);
    q->free_list_link = *my_free_list;
    *my_free_list = q;
 }
 
-template <bool threads, int inst>
-void* __default_alloc_template<threads, inst>::refill(size_t n) {
-   int nobjs = 20;
+template <bool threads, int inst, class SizeClasses>
+void* __default_alloc_template<threads, inst, SizeClasses>::allocate_n(
+    size_t n, size_t count) {
+   assert(n > 0);
+   if (0 == count) return 0;
+   if (n > SizeClasses::max_bytes) {
+      return (malloc_alloc::allocate_n(n, count));
+   }
+   n = SizeClasses::round_up(n);
+   lock guard;
+   obj* volatile* my_free_list = free_list + FREELIST_INDEX(n);
+   obj* result = *my_free_list;
+   obj* tail = 0;
+   // take the free blocks first
+   for (obj* q = result; q != 0 && count > 0; q = q->free_list_link) {
+      tail = q;
+      --count;
+   }
+   if (tail) {
+      *my_free_list = tail->free_list_link;
+      tail->free_list_link = 0;
+   } else {
+      result = 0;
+   }
+   // carve the rest from the pool, a run per round
+   while (count > 0) {
+      int nobjs = count > 4096 ? 4096 : static_cast<int>(count);
+      char* chunk = chunk_alloc(n, nobjs);
+      obj* run = reinterpret_cast<obj*>(chunk);
+      for (int i = 0; i < nobjs - 1; ++i) {
+         reinterpret_cast<obj*>(chunk + i * n)->free_list_link =
+             reinterpret_cast<obj*>(chunk + (i + 1) * n);
+      }
+      obj* last = reinterpret_cast<obj*>(chunk + (nobjs - 1) * n);
+      last->free_list_link = 0;
+      if (tail) {
+         tail->free_list_link = run;
+      } else {
+         result = run;
+      }
+      tail = last;
+      count -= nobjs;
+   }
+   return (result);
+}
+
+template <bool threads, int inst, class SizeClasses>
+void __default_alloc_template<threads, inst, SizeClasses>::deallocate_n(
+    void* p, size_t n, size_t count) {
+   if (0 == count) return;
+   if (n > SizeClasses::max_bytes) {
+      malloc_alloc::deallocate_n(p, n, count);
+      return;
+   }
+   obj* first = reinterpret_cast<obj*>(p);
+   obj* last = first;
+   for (size_t i = 1; i < count; ++i) last = last->free_list_link;
+   lock guard;
+   obj* volatile* my_free_list = free_list + FREELIST_INDEX(n);
+   last->free_list_link = *my_free_list;
+   *my_free_list = first;
+}
+
+template <bool threads, int inst, class SizeClasses>
+int __default_alloc_template<threads, inst, SizeClasses>::refill_batch(
+    size_t i, size_t n) {
+   const size_t now = ++refill_clock;
+   const size_t gap = now - last_refill[i];
+   int& b = batch[i];
+   if (last_refill[i] == 0) {
+      b = initial_batch;
+   } else if (gap <= SizeClasses::count) {
+      b *= 2;
+   } else if (gap > 4 * SizeClasses::count) {
+      b /= 2;
+   }
+   // at most max_batch objects and max_batch_bytes, but at least one
+   const size_t most = max_batch_bytes / n;
+   if (b < min_batch) b = min_batch;
+   if (b > max_batch) b = max_batch;
+   if (static_cast<size_t>(b) > most) b = most > 0 ? static_cast<int>(most) : 1;
+   last_refill[i] = now;
+   return b;
+}
+
+template <bool threads, int inst, class SizeClasses>
+void* __default_alloc_template<threads, inst, SizeClasses>::refill(size_t n) {
+   int nobjs = refill_batch(FREELIST_INDEX(n), n);
    // chunck_alloc() will try to get nobjs chunks of size n as new nodes for
    // free-list
    // notice: nobjs is passed by reference
@@ -206,9 +419,9 @@ void* __default_alloc_template<threads, inst>::refill(size_t n) {
    return (result);
 }
 
-template <bool threads, int inst>
-char* __default_alloc_template<threads, inst>::chunk_alloc(size_t size,
-                                                           int& nobjs) {
+template <bool threads, int inst, class SizeClasses>
+char* __default_alloc_template<threads, inst, SizeClasses>::chunk_alloc(
+    size_t size, int& nobjs) {
    char* result;
    size_t total_bytes = size * nobjs;  // the bytes required
    size_t bytes_left =
@@ -228,29 +441,32 @@ char* __default_alloc_template<threads, inst>::chunk_alloc(size_t size,
    } else {
       // no enough space for even one chunk
       size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
-      // try to put the remain bytes into free-list
-      if (bytes_left > 0) {
-         obj* volatile* my_free_list = free_list + FREELIST_INDEX(bytes_left);
+      // try to put the remain bytes into free-list, largest class first
+      while (bytes_left >= SizeClasses::sizes[0]) {
+         size_t i = FREELIST_INDEX(bytes_left);
+         if (SizeClasses::sizes[i] > bytes_left) --i;
+         obj* volatile* my_free_list = free_list + i;
          reinterpret_cast<obj*>(start_free)->free_list_link = *my_free_list;
          *my_free_list = reinterpret_cast<obj*>(start_free);
+         start_free += SizeClasses::sizes[i];
+         bytes_left -= SizeClasses::sizes[i];
       }
 
       // get some new space
       start_free = reinterpret_cast<char*>(std::malloc(bytes_to_get));
       if (0 == start_free) {
          // no enough space in heap
-         int i;
          obj* volatile* my_free_list;
          obj* p;
 
          // try to search a free-list that have enough space and available
-         for (i = size; i <= __MAX_BYTES; i += __ALIGN) {
-            my_free_list = free_list + FREELIST_INDEX(i);
+         for (size_t i = FREELIST_INDEX(size); i < SizeClasses::count; ++i) {
+            my_free_list = free_list + i;
             p = *my_free_list;
             if (0 != p) {
                *my_free_list = p->free_list_link;
                start_free = reinterpret_cast<char*>(p);
-               end_free = start_free + i;
+               end_free = start_free + SizeClasses::sizes[i];
                // recurisve to fix nobjs
                return (chunk_alloc(size, nobjs));
             }
@@ -1,13 +1,37 @@
 #ifndef _ALLOCTOR_H_
 #define _ALLOCTOR_H_
 #include "alloc.h"
+#include "heap_profiler.h"
 
 namespace tinystl {
 #ifdef __USE_MALLOC
 typedef tinystl::__malloc_alloc_template<0> malloc_alloc;
 typedef malloc_alloc alloc;
+typedef malloc_alloc thread_alloc;
 #else
 typedef tinystl::__default_alloc_template<0, 0> alloc;
+// locks the pool, for containers that allocate from many threads
+typedef tinystl::__default_alloc_template<true, 0> thread_alloc;
+#endif
+
+// statements, used with a trailing semicolon
+#ifdef __NO_HEAP_PROFILER
+#define __HEAP_PROFILE_ALLOCATE(p, bytes) \
+   do {                                   \
+   } while (0)
+#define __HEAP_PROFILE_DEALLOCATE(p) \
+   do {                              \
+   } while (0)
+#else
+#define __HEAP_PROFILE_ALLOCATE(p, bytes)                            \
+   do {                                                              \
+      if (heap_profiler::enabled())                                  \
+         heap_profiler::record_allocate(p, bytes, __type_name<T>()); \
+   } while (0)
+#define __HEAP_PROFILE_DEALLOCATE(p)                                     \
+   do {                                                                  \
+      if (heap_profiler::enabled()) heap_profiler::record_deallocate(p); \
+   } while (0)
 #endif
 
 template <class T, class Alloc>
@@ -15,15 +39,52 @@ class simple_alloc {  // a simple wrapper for _malloc_alloc and
                       // _default_alloc
   public:
    static T* allocate(size_t n) {
-      return 0 == n ? 0 : static_cast<T*>(Alloc::allocate(n * sizeof(T)));
+      if (0 == n) return 0;
+      T* p = static_cast<T*>(Alloc::allocate(n * sizeof(T)));
+      __HEAP_PROFILE_ALLOCATE(p, n * sizeof(T));
+      return p;
    }
    static T* allocate(void) {
-      return static_cast<T*>(Alloc::allocate(sizeof(T)));
+      T* p = static_cast<T*>(Alloc::allocate(sizeof(T)));
+      __HEAP_PROFILE_ALLOCATE(p, sizeof(T));
+      return p;
    }
    static void deallocate(T* p, size_t n) {
-      if (0 != n) Alloc::deallocate(p, n * sizeof(T));
+      if (0 == n) return;
+      __HEAP_PROFILE_DEALLOCATE(p);
+      Alloc::deallocate(p, n * sizeof(T));
+   }
+   static void deallocate(T* p) {
+      __HEAP_PROFILE_DEALLOCATE(p);
+      Alloc::deallocate(p, sizeof(T));
+   }
+
+   // n objects in one round trip, linked through their first word: walk
+   // them with next_in_chain, each can be freed alone with deallocate(p)
+   static T* allocate_n(size_t n) {
+      if (0 == n) return 0;
+      T* p = static_cast<T*>(Alloc::allocate_n(sizeof(T), n));
+#ifndef __NO_HEAP_PROFILER
+      for (T* q = p; q && heap_profiler::enabled(); q = next_in_chain(q)) {
+         __HEAP_PROFILE_ALLOCATE(q, sizeof(T));
+      }
+#endif
+      return p;
+   }
+   // n objects still linked as allocate_n returns them
+   static void deallocate_n(T* p, size_t n) {
+      if (0 == n) return;
+#ifndef __NO_HEAP_PROFILER
+      T* q = p;
+      for (size_t i = 0; i < n && heap_profiler::enabled(); ++i) {
+         T* next = next_in_chain(q);
+         __HEAP_PROFILE_DEALLOCATE(q);
+         q = next;
+      }
+#endif
+      Alloc::deallocate_n(p, sizeof(T), n);
    }
-   static void deallocate(T* p) { Alloc::deallocate(p, sizeof(T)); }
+   static T* next_in_chain(T* p) { return *reinterpret_cast<T**>(p); }
 };
 }  // namespace tinystl
 
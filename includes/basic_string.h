@@ -0,0 +1,357 @@
+#ifndef _BASIC_STRING_H_
+#define _BASIC_STRING_H_
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "allocator.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace tinystl {
+// A string with small-string optimization.
+//
+// The representation is three words. A long string uses them as pointer,
+// size and capacity; a short one keeps up to small_capacity characters
+// (23 for char) inline. The last byte of the representation says which:
+// for a short string it holds small_capacity - size(), so it doubles as the
+// terminator of a full short string, and a long string sets its top bit,
+// which falls in the capacity word and is placed according to byte order.
+//
+// Heap buffers come from simple_alloc and grow with the vector policy;
+// copies go through the memmove overloads of uninitialized_copy and
+// searches through char_traits::find, which is memchr for char.
+template <class CharT, class Alloc = alloc>
+class basic_string {
+  public:
+   typedef CharT value_type;
+   typedef value_type* pointer;
+   typedef value_type* iterator;
+   typedef const value_type* const_iterator;
+   typedef value_type& reference;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef std::char_traits<CharT> traits_type;
+
+   static const size_type npos = ~size_type(0);
+
+  protected:
+   typedef simple_alloc<value_type, Alloc> data_allocator;
+
+   struct long_rep {
+      pointer ptr;
+      size_type size;
+      size_type cap;  // encoded, see encode_cap
+   };
+
+  public:
+   enum { small_capacity = sizeof(long_rep) / sizeof(CharT) - 1 };
+
+  protected:
+   static_assert(sizeof(long_rep) % sizeof(CharT) == 0,
+                 "character size must divide the representation");
+
+   union {
+      long_rep l;
+      value_type s[small_capacity + 1];
+   } r;
+
+   enum { long_bit = 0x80 };
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+   // the last byte is the low byte of cap
+   static size_type encode_cap(size_type n) { return n << 8 | long_bit; }
+   static size_type decode_cap(size_type c) { return c >> 8; }
+#else
+   // the last byte is the high byte of cap
+   static size_type long_flag() {
+      return size_type(long_bit) << (8 * (sizeof(size_type) - 1));
+   }
+   static size_type encode_cap(size_type n) { return n | long_flag(); }
+   static size_type decode_cap(size_type c) { return c & ~long_flag(); }
+#endif
+
+   unsigned char last_byte() const {
+      return reinterpret_cast<const unsigned char*>(&r)[sizeof(r) - 1];
+   }
+   bool is_long() const { return (last_byte() & long_bit) != 0; }
+
+   void set_small_size(size_type n) {
+      reinterpret_cast<unsigned char*>(&r)[sizeof(r) - 1] =
+          static_cast<unsigned char>(small_capacity - n);
+      r.s[n] = CharT();
+   }
+   void set_size(size_type n) {
+      if (is_long()) {
+         r.l.size = n;
+         r.l.ptr[n] = CharT();
+      } else {
+         set_small_size(n);
+      }
+   }
+   void set_long(pointer p, size_type n, size_type cap) {
+      r.l.ptr = p;
+      r.l.size = n;
+      r.l.cap = encode_cap(cap);
+      p[n] = CharT();
+   }
+
+   static pointer allocate(size_type cap) {
+      return data_allocator::allocate(cap + 1);
+   }
+   void deallocate() {
+      if (is_long()) data_allocator::deallocate(r.l.ptr, capacity() + 1);
+   }
+
+   // copy [first, first + n) into raw characters at result
+   static pointer copy_chars(const CharT* first, size_type n, pointer result) {
+      return tinystl::uninitialized_copy(first, first + n, result);
+   }
+
+   void init(const CharT* p, size_type n) {
+      if (n <= small_capacity) {
+         copy_chars(p, n, r.s);
+         set_small_size(n);
+      } else {
+         pointer buf = allocate(n);
+         copy_chars(p, n, buf);
+         set_long(buf, n, n);
+      }
+   }
+
+   // reallocate to cap, keeping the contents and appending [p, p + n)
+   void grow_and_append(size_type cap, const CharT* p, size_type n) {
+      const size_type old_size = size();
+      pointer buf = allocate(cap);
+      copy_chars(data(), old_size, buf);
+      // p may point into the old buffer, copy it before freeing that
+      if (n) copy_chars(p, n, buf + old_size);
+      deallocate();
+      set_long(buf, old_size + n, cap);
+   }
+
+  public:
+   basic_string() { set_small_size(0); }
+   basic_string(const CharT* p) { init(p, traits_type::length(p)); }
+   basic_string(const CharT* p, size_type n) { init(p, n); }
+   basic_string(size_type n, CharT c) {
+      set_small_size(0);
+      resize(n, c);
+   }
+   basic_string(const basic_string& x) {
+      if (x.is_long())
+         init(x.data(), x.size());
+      else
+         r = x.r;
+   }
+   basic_string(basic_string&& x) noexcept {
+      r = x.r;
+      x.set_small_size(0);
+   }
+   ~basic_string() { deallocate(); }
+
+   basic_string& operator=(const basic_string& x) {
+      if (this != &x) assign(x.data(), x.size());
+      return *this;
+   }
+   basic_string& operator=(basic_string&& x) noexcept {
+      if (this != &x) {
+         deallocate();
+         r = x.r;
+         x.set_small_size(0);
+      }
+      return *this;
+   }
+   basic_string& operator=(const CharT* p) {
+      return assign(p, traits_type::length(p));
+   }
+
+   iterator begin() const { return data(); }
+   iterator end() const { return data() + size(); }
+   pointer data() const {
+      return is_long() ? r.l.ptr : const_cast<pointer>(r.s);
+   }
+   const CharT* c_str() const { return data(); }
+   size_type size() const {
+      return is_long() ? r.l.size : small_capacity - last_byte();
+   }
+   size_type length() const { return size(); }
+   size_type capacity() const {
+      return is_long() ? decode_cap(r.l.cap) : size_type(small_capacity);
+   }
+   bool empty() const { return size() == 0; }
+   reference operator[](size_type n) const { return data()[n]; }
+   reference front() const { return data()[0]; }
+   reference back() const { return data()[size() - 1]; }
+
+   void reserve(size_type n) {
+      if (n > capacity()) grow_and_append(n, 0, 0);
+   }
+
+   basic_string& assign(const CharT* p, size_type n) {
+      if (n <= capacity()) {
+         traits_type::move(data(), p, n);
+         set_size(n);
+      } else {
+         pointer buf = allocate(n);
+         copy_chars(p, n, buf);
+         deallocate();
+         set_long(buf, n, n);
+      }
+      return *this;
+   }
+
+   basic_string& append(const CharT* p, size_type n) {
+      const size_type old_size = size();
+      if (n > capacity() - old_size) {
+         const size_type cap = capacity();
+         grow_and_append(__vector_next_capacity(cap, old_size + n - cap), p,
+                         n);
+      } else {
+         traits_type::move(data() + old_size, p, n);
+         set_size(old_size + n);
+      }
+      return *this;
+   }
+   basic_string& append(const CharT* p) {
+      return append(p, traits_type::length(p));
+   }
+   basic_string& append(const basic_string& x) {
+      return append(x.data(), x.size());
+   }
+   basic_string& operator+=(const basic_string& x) { return append(x); }
+   basic_string& operator+=(const CharT* p) { return append(p); }
+   basic_string& operator+=(CharT c) {
+      push_back(c);
+      return *this;
+   }
+
+   void push_back(CharT c) { append(&c, 1); }
+   void pop_back() { set_size(size() - 1); }
+
+   void resize(size_type n, CharT c = CharT()) {
+      const size_type old_size = size();
+      if (n > old_size) {
+         reserve(n);
+         traits_type::assign(data() + old_size, n - old_size, c);
+      }
+      set_size(n);
+   }
+   void clear() { set_size(0); }
+
+   basic_string substr(size_type pos = 0, size_type n = npos) const {
+      assert(pos <= size() && "substr position out of range");
+      if (n > size() - pos) n = size() - pos;
+      return basic_string(data() + pos, n);
+   }
+
+   size_type find(CharT c, size_type pos = 0) const {
+      const size_type sz = size();
+      if (pos >= sz) return npos;
+      const CharT* p = traits_type::find(data() + pos, sz - pos, c);
+      return p ? static_cast<size_type>(p - data()) : npos;
+   }
+
+   // candidates for the first character come from char_traits::find
+   size_type find(const CharT* p, size_type pos, size_type n) const {
+      const size_type sz = size();
+      if (n == 0) return pos <= sz ? pos : npos;
+      if (pos > sz || n > sz - pos) return npos;
+      const CharT* first = data() + pos;
+      const CharT* const last = data() + (sz - n + 1);
+      while (first < last) {
+         first = traits_type::find(first, last - first, p[0]);
+         if (0 == first) return npos;
+         if (traits_type::compare(first + 1, p + 1, n - 1) == 0)
+            return static_cast<size_type>(first - data());
+         ++first;
+      }
+      return npos;
+   }
+   size_type find(const CharT* p, size_type pos = 0) const {
+      return find(p, pos, traits_type::length(p));
+   }
+   size_type find(const basic_string& x, size_type pos = 0) const {
+      return find(x.data(), pos, x.size());
+   }
+
+   size_type rfind(CharT c, size_type pos = npos) const {
+      const size_type sz = size();
+      if (sz == 0) return npos;
+      size_type i = pos < sz - 1 ? pos : sz - 1;
+      for (const CharT* p = data();; --i) {
+         if (traits_type::eq(p[i], c)) return i;
+         if (i == 0) return npos;
+      }
+   }
+
+   int compare(const CharT* p, size_type n) const {
+      const size_type sz = size();
+      int result = traits_type::compare(data(), p, sz < n ? sz : n);
+      if (result != 0) return result;
+      return sz < n ? -1 : (sz > n ? 1 : 0);
+   }
+   int compare(const basic_string& x) const {
+      return compare(x.data(), x.size());
+   }
+};
+
+template <class CharT, class Alloc>
+const typename basic_string<CharT, Alloc>::size_type
+    basic_string<CharT, Alloc>::npos;
+
+template <class CharT, class Alloc>
+inline bool operator==(const basic_string<CharT, Alloc>& x,
+                       const basic_string<CharT, Alloc>& y) {
+   return x.size() == y.size() && x.compare(y) == 0;
+}
+
+template <class CharT, class Alloc>
+inline bool operator==(const basic_string<CharT, Alloc>& x, const CharT* p) {
+   return x.compare(p, std::char_traits<CharT>::length(p)) == 0;
+}
+
+template <class CharT, class Alloc>
+inline bool operator!=(const basic_string<CharT, Alloc>& x,
+                       const basic_string<CharT, Alloc>& y) {
+   return !(x == y);
+}
+
+template <class CharT, class Alloc>
+inline bool operator<(const basic_string<CharT, Alloc>& x,
+                      const basic_string<CharT, Alloc>& y) {
+   return x.compare(y) < 0;
+}
+
+template <class CharT, class Alloc>
+inline basic_string<CharT, Alloc> operator+(
+    const basic_string<CharT, Alloc>& x, const basic_string<CharT, Alloc>& y) {
+   basic_string<CharT, Alloc> result;
+   result.reserve(x.size() + y.size());
+   result.append(x);
+   result.append(y);
+   return result;
+}
+
+template <class CharT, class Alloc>
+inline basic_string<CharT, Alloc> operator+(
+    const basic_string<CharT, Alloc>& x, const CharT* p) {
+   basic_string<CharT, Alloc> result(x);
+   result.append(p);
+   return result;
+}
+
+template <class CharT, class Alloc>
+inline std::basic_ostream<CharT>& operator<<(
+    std::basic_ostream<CharT>& out, const basic_string<CharT, Alloc>& x) {
+   return out.write(x.data(), x.size());
+}
+
+typedef basic_string<char> string;
+typedef basic_string<wchar_t> wstring;
+}  // namespace tinystl
+
+#endif
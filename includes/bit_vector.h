@@ -0,0 +1,317 @@
+#ifndef _BIT_VECTOR_H_
+#define _BIT_VECTOR_H_
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include "allocator.h"
+#include "iterator.h"
+#include "vector.h"
+
+namespace tinystl {
+typedef unsigned long long __bit_word;
+enum { __word_bits = 64 };
+
+inline size_t __popcount(__bit_word x) {
+#if defined(__GNUC__) || defined(__clang__)
+   return static_cast<size_t>(__builtin_popcountll(x));
+#else
+   size_t n = 0;
+   for (; x; x &= x - 1) ++n;
+   return n;
+#endif
+}
+
+// index of the lowest set bit, x must not be 0
+inline size_t __lowest_bit(__bit_word x) {
+#if defined(__GNUC__) || defined(__clang__)
+   return static_cast<size_t>(__builtin_ctzll(x));
+#else
+   size_t n = 0;
+   for (; !(x & 1); x >>= 1) ++n;
+   return n;
+#endif
+}
+
+struct __bit_reference {
+   __bit_word* p;
+   __bit_word mask;
+
+   __bit_reference(__bit_word* x, __bit_word m) : p(x), mask(m) {}
+
+   operator bool() const { return (*p & mask) != 0; }
+   bool operator~() const { return (*p & mask) == 0; }
+   __bit_reference& operator=(bool x) {
+      if (x)
+         *p |= mask;
+      else
+         *p &= ~mask;
+      return *this;
+   }
+   __bit_reference& operator=(const __bit_reference& x) {
+      return *this = bool(x);
+   }
+   bool operator==(const __bit_reference& x) const {
+      return bool(*this) == bool(x);
+   }
+   void flip() { *p ^= mask; }
+};
+
+inline void swap(__bit_reference x, __bit_reference y) {
+   bool tmp = x;
+   x = y;
+   y = tmp;
+}
+
+struct __bit_iterator : public iterator<random_access_iterator_tag, bool,
+                                        std::ptrdiff_t, void, __bit_reference> {
+   typedef __bit_iterator self;
+   typedef __bit_reference reference;
+   typedef std::ptrdiff_t difference_type;
+
+   __bit_word* p;
+   unsigned int offset;
+
+   __bit_iterator() : p(0), offset(0) {}
+   __bit_iterator(__bit_word* x, unsigned int n) : p(x), offset(n) {}
+
+   void bump_up() {
+      if (offset++ == __word_bits - 1) {
+         offset = 0;
+         ++p;
+      }
+   }
+   void bump_down() {
+      if (offset-- == 0) {
+         offset = __word_bits - 1;
+         --p;
+      }
+   }
+
+   reference operator*() const {
+      return reference(p, __bit_word(1) << offset);
+   }
+   reference operator[](difference_type n) const { return *(*this + n); }
+
+   self& operator++() {
+      bump_up();
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      bump_up();
+      return tmp;
+   }
+   self& operator--() {
+      bump_down();
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      bump_down();
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      difference_type bit = n + offset;
+      p += bit / __word_bits;
+      bit = bit % __word_bits;
+      if (bit < 0) {
+         bit += __word_bits;
+         --p;
+      }
+      offset = static_cast<unsigned int>(bit);
+      return *this;
+   }
+   self& operator-=(difference_type n) { return *this += -n; }
+   self operator+(difference_type n) const {
+      self tmp = *this;
+      return tmp += n;
+   }
+   self operator-(difference_type n) const {
+      self tmp = *this;
+      return tmp -= n;
+   }
+   difference_type operator-(const self& x) const {
+      return __word_bits * (p - x.p) + offset - x.offset;
+   }
+
+   bool operator==(const self& x) const {
+      return p == x.p && offset == x.offset;
+   }
+   bool operator!=(const self& x) const { return !(*this == x); }
+   bool operator<(const self& x) const {
+      return p < x.p || (p == x.p && offset < x.offset);
+   }
+   bool operator>(const self& x) const { return x < *this; }
+   bool operator<=(const self& x) const { return !(x < *this); }
+   bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+// A vector of bools packed 64 to a word.
+//
+// Bits past size() in the last word are always zero, so count(), the
+// searches and the bitwise operators work a whole word at a time without
+// masking; the word loops are simple enough for the compiler to vectorize.
+template <class Alloc>
+class __bit_vector {
+  public:
+   typedef bool value_type;
+   typedef __bit_reference reference;
+   typedef bool const_reference;
+   typedef __bit_iterator iterator;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+
+  protected:
+   typedef simple_alloc<__bit_word, Alloc> data_allocator;
+
+   __bit_word* start;
+   size_type len;        // in bits
+   size_type words_cap;  // in words
+
+   static size_type words_for(size_type bits) {
+      return (bits + __word_bits - 1) / __word_bits;
+   }
+   size_type words() const { return words_for(len); }
+
+   void reallocate(size_type n) {
+      __bit_word* new_start = data_allocator::allocate(n);
+      if (words()) std::memcpy(new_start, start, words() * sizeof(__bit_word));
+      data_allocator::deallocate(start, words_cap);
+      start = new_start;
+      words_cap = n;
+   }
+
+   // zero the bits of the last word past size()
+   void clear_tail() {
+      if (len % __word_bits)
+         start[len / __word_bits] &= (__bit_word(1) << len % __word_bits) - 1;
+   }
+
+   // first set bit at or after word w, or size()
+   size_type scan(size_type w) const {
+      for (const size_type n = words(); w < n; ++w) {
+         if (start[w]) return w * __word_bits + __lowest_bit(start[w]);
+      }
+      return len;
+   }
+
+  public:
+   __bit_vector() : start(0), len(0), words_cap(0) {}
+   explicit __bit_vector(size_type n, bool value = false)
+       : start(0), len(0), words_cap(0) {
+      resize(n, value);
+   }
+   ~__bit_vector() { data_allocator::deallocate(start, words_cap); }
+
+   __bit_vector(const __bit_vector&) = delete;
+   __bit_vector& operator=(const __bit_vector&) = delete;
+
+   iterator begin() const { return iterator(start, 0); }
+   iterator end() const { return begin() + len; }
+   size_type size() const { return len; }
+   size_type capacity() const { return words_cap * __word_bits; }
+   bool empty() const { return len == 0; }
+
+   // the packed words, bit i is bit i % 64 of word i / 64
+   __bit_word* data() const { return start; }
+
+   reference operator[](size_type n) const {
+      return reference(start + n / __word_bits,
+                       __bit_word(1) << n % __word_bits);
+   }
+   bool test(size_type n) const { return (*this)[n]; }
+   reference front() const { return (*this)[0]; }
+   reference back() const { return (*this)[len - 1]; }
+
+   void reserve(size_type bits) {
+      if (words_for(bits) > words_cap) reallocate(words_for(bits));
+   }
+
+   void push_back(bool x) {
+      if (len == capacity())
+         reallocate(__vector_next_capacity(words_cap, 1));
+      if (len % __word_bits == 0) start[len / __word_bits] = 0;
+      ++len;
+      back() = x;
+   }
+   void pop_back() {
+      --len;
+      clear_tail();
+   }
+
+   void resize(size_type n, bool x = false) {
+      if (n <= len) {
+         len = n;
+         clear_tail();
+         return;
+      }
+      const size_type need = words_for(n);
+      if (need > words_cap)
+         reallocate(__vector_next_capacity(words_cap, need - words_cap));
+      const size_type old_len = len;
+      const size_type old_words = words();
+      std::memset(start + old_words, x ? 0xff : 0,
+                  (need - old_words) * sizeof(__bit_word));
+      if (x && old_len % __word_bits) {
+         start[old_len / __word_bits] |= ~__bit_word(0)
+                                         << old_len % __word_bits;
+      }
+      len = n;
+      clear_tail();
+   }
+   void clear() { len = 0; }
+
+   void set() {
+      std::memset(start, 0xff, words() * sizeof(__bit_word));
+      clear_tail();
+   }
+   void reset() { std::memset(start, 0, words() * sizeof(__bit_word)); }
+   void flip() {
+      for (size_type w = 0, n = words(); w < n; ++w) start[w] = ~start[w];
+      clear_tail();
+   }
+
+   // number of set bits
+   size_type count() const {
+      size_type n = 0;
+      for (size_type w = 0, e = words(); w < e; ++w) n += __popcount(start[w]);
+      return n;
+   }
+   bool any() const { return find_first() != len; }
+   bool none() const { return !any(); }
+
+   // position of the first set bit, or size() if there is none
+   size_type find_first() const { return scan(0); }
+
+   // position of the first set bit after pos, or size() if there is none
+   size_type find_next(size_type pos) const {
+      if (++pos >= len) return len;
+      const size_type w = pos / __word_bits;
+      const __bit_word rest = start[w] & (~__bit_word(0) << pos % __word_bits);
+      if (rest) return w * __word_bits + __lowest_bit(rest);
+      return scan(w + 1);
+   }
+
+   // bitwise operators need vectors of the same size
+   __bit_vector& operator&=(const __bit_vector& x) {
+      assert(len == x.len && "bit_vector sizes differ");
+      for (size_type w = 0, n = words(); w < n; ++w) start[w] &= x.start[w];
+      return *this;
+   }
+   __bit_vector& operator|=(const __bit_vector& x) {
+      assert(len == x.len && "bit_vector sizes differ");
+      for (size_type w = 0, n = words(); w < n; ++w) start[w] |= x.start[w];
+      return *this;
+   }
+   __bit_vector& operator^=(const __bit_vector& x) {
+      assert(len == x.len && "bit_vector sizes differ");
+      for (size_type w = 0, n = words(); w < n; ++w) start[w] ^= x.start[w];
+      return *this;
+   }
+};
+
+typedef __bit_vector<alloc> bit_vector;
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,452 @@
+#ifndef _CONCURRENT_SKIP_LIST_H_
+#define _CONCURRENT_SKIP_LIST_H_
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <utility>
+
+#include "allocator.h"
+#include "epoch.h"
+#include "iterator.h"
+
+namespace tinystl {
+enum { __skip_max_level = 32 };
+
+// birth and death stamp of a write that is linked but not yet stamped
+static const uint64_t __skip_pending = ~uint64_t(0);
+
+template <class K, class V>
+struct __skip_node {
+   typedef std::pair<const K, V> value_type;
+
+   value_type data;
+   std::atomic<uint64_t> birth;
+   std::atomic<uint64_t> death;  // 0 while alive
+   std::atomic<int> refs;        // the inserter and the remover
+   int level;
+   std::atomic<uintptr_t> next[1];  // level links, low bit marks removal
+
+   __skip_node(const K& k, const V& v, int n)
+       : data(k, v), birth(__skip_pending), death(0), refs(2), level(n) {
+      next[0].store(0, std::memory_order_relaxed);
+      for (int i = 1; i < n; ++i) new (&next[i]) std::atomic<uintptr_t>(0);
+   }
+
+   static size_t bytes(int n) {
+      return sizeof(__skip_node) + (n - 1) * sizeof(std::atomic<uintptr_t>);
+   }
+};
+
+inline bool __skip_marked(uintptr_t x) { return (x & 1) != 0; }
+
+// the stamp, assigning one from the clock if its write is still pending; any
+// thread may do it, the first assignment wins
+inline uint64_t __skip_resolve(std::atomic<uint64_t>& stamp) {
+   uint64_t s = stamp.load();
+   if (s != __skip_pending) return s;
+   const uint64_t now = __epoch::clock().fetch_add(1) + 1;
+   stamp.compare_exchange_strong(s, now);
+   return stamp.load();
+}
+
+template <class K, class V, class Compare, class Alloc>
+class concurrent_skip_list;
+
+template <class List>
+struct __skip_list_iterator
+    : public iterator<forward_iterator_tag, typename List::value_type,
+                      std::ptrdiff_t, const typename List::value_type*,
+                      const typename List::value_type&> {
+   typedef __skip_list_iterator<List> self;
+   typedef typename List::node node;
+   typedef const typename List::value_type& reference;
+   typedef const typename List::value_type* pointer;
+
+   node* cur;
+   uint64_t stamp;
+
+   __skip_list_iterator() : cur(0), stamp(0) {}
+   __skip_list_iterator(node* x, uint64_t s) : cur(x), stamp(s) {
+      skip_invisible();
+   }
+
+   void skip_invisible() {
+      while (cur && !List::visible(cur, stamp)) {
+         cur = List::ptr(cur->next[0].load());
+      }
+   }
+
+   reference operator*() const { return cur->data; }
+   pointer operator->() const { return &cur->data; }
+   self& operator++() {
+      cur = List::ptr(cur->next[0].load());
+      skip_invisible();
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   bool operator==(const self& x) const { return cur == x.cur; }
+   bool operator!=(const self& x) const { return cur != x.cur; }
+};
+
+// An ordered map that many threads can insert into, erase from and read at
+// once, without locks.
+//
+// A skip list after Fraser and Herlihy-Shavit: each level is a Harris list
+// whose links carry a removal mark in their low bit. A removal marks the
+// tower top down and the thread that marks level 0 unlinks it; searches
+// snip marked nodes as they pass. Towers are sized to their level and come
+// from Alloc, the locked pool by default since any thread may free them.
+// Unlinked towers are retired to the epoch reclamation in epoch.h.
+//
+// Range reads go through a snapshot. Inserts and erases stamp their node
+// from a global clock when they take effect, and a snapshot sees a node if
+// it was born at or before the snapshot's stamp and did not die by then.
+// An erased node stays linked, as a tombstone, while a snapshot that can
+// see it is held. Later writes to its key unlink it. So the versions of a
+// key lie next to each other, with at most one alive, and at most one is
+// visible to any snapshot. A snapshot pins its thread and must be used and
+// destroyed on that thread. It also holds back reclamation, so scans should
+// be short.
+template <class K, class V, class Compare = std::less<K>,
+          class Alloc = thread_alloc>
+class concurrent_skip_list {
+  public:
+   typedef K key_type;
+   typedef V mapped_type;
+   typedef std::pair<const K, V> value_type;
+   typedef size_t size_type;
+   typedef __skip_node<K, V> node;
+   typedef __skip_list_iterator<concurrent_skip_list> iterator;
+   typedef iterator const_iterator;
+
+  protected:
+   typedef std::atomic<uintptr_t> link;
+   typedef simple_alloc<char, Alloc> node_allocator;
+
+   link head[__skip_max_level];
+   std::atomic<size_type> count;
+   Compare comp;
+
+   friend struct __skip_list_iterator<concurrent_skip_list>;
+
+   static node* ptr(uintptr_t x) { return reinterpret_cast<node*>(x & ~1); }
+
+   static bool visible(node* x, uint64_t stamp) {
+      if (__skip_resolve(x->birth) > stamp) return false;
+      const uint64_t d = x->death.load();
+      return d == 0 || __skip_resolve(x->death) > stamp;
+   }
+
+   static int random_level() {
+      static thread_local uint64_t seed =
+          0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&seed);
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      // p = 1/2 per level
+      const uint64_t top = uint64_t(1) << (__skip_max_level - 1);
+      return 1 + __builtin_ctzll(seed | top);
+   }
+
+   static node* new_node(const K& key, const V& value, int level) {
+      void* p = node_allocator::allocate(node::bytes(level));
+      try {
+         return new (p) node(key, value, level);
+      } catch (...) {
+         node_allocator::deallocate(static_cast<char*>(p), node::bytes(level));
+         throw;
+      }
+   }
+   static void delete_node(void* p) {
+      node* x = static_cast<node*>(p);
+      const int level = x->level;
+      x->~node();
+      node_allocator::deallocate(static_cast<char*>(p), node::bytes(level));
+   }
+   static void release(node* x) {
+      if (x->refs.fetch_sub(1) == 1) __epoch::retire(x, &delete_node);
+   }
+
+   bool less(const K& a, const K& b) const { return comp(a, b); }
+   bool before(node* x, const K& key) const { return less(x->data.first, key); }
+   bool same(node* x, const K& key) const { return !less(key, x->data.first); }
+
+   // preds[l] is the link array of the last node before key on level l and
+   // succs[l] the node after it; snips the marked nodes on the way
+   void search(const K& key, link** preds, node** succs) {
+   retry:
+      link* pred = head;
+      for (int l = __skip_max_level - 1; l >= 0; --l) {
+         node* cur = ptr(pred[l].load());
+         while (cur) {
+            uintptr_t succ = cur->next[l].load();
+            if (__skip_marked(succ)) {
+               uintptr_t expected = reinterpret_cast<uintptr_t>(cur);
+               if (!pred[l].compare_exchange_strong(expected, succ & ~1)) {
+                  goto retry;
+               }
+               cur = ptr(succ);
+            } else if (before(cur, key)) {
+               pred = cur->next;
+               cur = ptr(succ);
+            } else {
+               break;
+            }
+         }
+         preds[l] = pred;
+         succs[l] = cur;
+      }
+   }
+
+   // unlink every marked version of key on every level; the versions
+   // don't keep one order across levels, so each level is walked from the
+   // node before them
+   void unlink_key(const K& key) {
+      link* preds[__skip_max_level];
+      node* succs[__skip_max_level];
+   retry:
+      search(key, preds, succs);
+      for (int l = __skip_max_level - 1; l >= 0; --l) {
+         link* pred = preds[l];
+         node* cur = succs[l];
+         while (cur && same(cur, key)) {
+            uintptr_t succ = cur->next[l].load();
+            if (__skip_marked(succ)) {
+               uintptr_t expected = reinterpret_cast<uintptr_t>(cur);
+               if (!pred[l].compare_exchange_strong(expected, succ & ~1)) {
+                  goto retry;
+               }
+            } else {
+               pred = cur->next;
+            }
+            cur = ptr(succ);
+         }
+      }
+   }
+
+   // mark the tower of a dead node and unlink it, false if another thread
+   // got to it first
+   bool remove(node* x) {
+      for (int l = x->level - 1; l > 0; --l) {
+         uintptr_t succ = x->next[l].load();
+         while (!__skip_marked(succ) &&
+                !x->next[l].compare_exchange_weak(succ, succ | 1)) {
+         }
+      }
+      uintptr_t succ = x->next[0].load();
+      do {
+         if (__skip_marked(succ)) return false;
+      } while (!x->next[0].compare_exchange_weak(succ, succ | 1));
+      unlink_key(x->data.first);
+      release(x);
+      return true;
+   }
+
+   // x is dead and no snapshot, held or future, can see it
+   static bool reclaimable(node* x) {
+      const uint64_t d = x->death.load();
+      return d != 0 && d != __skip_pending &&
+             d <= __epoch::oldest_snapshot();
+   }
+
+   // the live version among the versions of key from x on; unlinks the
+   // dead ones nobody can see, and returns null with *removed set if it
+   // did, as the caller's search is stale then
+   node* live_version(node* x, const K& key, bool* removed) {
+      *removed = false;
+      for (; x && same(x, key); x = ptr(x->next[0].load())) {
+         if (__skip_marked(x->next[0].load())) continue;
+         if (x->death.load() == 0) return x;
+         __skip_resolve(x->death);
+         if (reclaimable(x) && remove(x)) *removed = true;
+      }
+      return 0;
+   }
+
+   // the live version of key, the caller is pinned; reads only
+   node* lookup(const K& key) const {
+      const link* pred = head;
+      node* cur = 0;
+      for (int l = __skip_max_level - 1; l >= 0; --l) {
+         cur = ptr(pred[l].load());
+         while (cur && before(cur, key)) {
+            pred = cur->next;
+            cur = ptr(pred[l].load());
+         }
+      }
+      for (; cur && same(cur, key); cur = ptr(cur->next[0].load())) {
+         if (!__skip_marked(cur->next[0].load()) && cur->death.load() == 0) {
+            return cur;
+         }
+      }
+      return 0;
+   }
+
+  public:
+   concurrent_skip_list() : count(0) {
+      for (int l = 0; l < __skip_max_level; ++l) head[l].store(0);
+   }
+   // no other thread may use the list any more
+   ~concurrent_skip_list() {
+      node* x = ptr(head[0].load());
+      while (x) {
+         node* next = ptr(x->next[0].load());
+         delete_node(x);
+         x = next;
+      }
+   }
+
+   concurrent_skip_list(const concurrent_skip_list&) = delete;
+   concurrent_skip_list& operator=(const concurrent_skip_list&) = delete;
+
+   // live elements, exact once writers are done
+   size_type size() const { return count.load(std::memory_order_relaxed); }
+   bool empty() const { return size() == 0; }
+
+   // false and no change if key is already there
+   bool insert(const K& key, const V& value) {
+      __epoch_guard guard;
+      link* preds[__skip_max_level];
+      node* succs[__skip_max_level];
+      const int level = random_level();
+      node* x = 0;
+      for (;;) {
+         search(key, preds, succs);
+         bool removed;
+         if (live_version(succs[0], key, &removed)) {
+            if (x) delete_node(x);
+            return false;
+         }
+         if (removed) continue;
+         if (!x) x = new_node(key, value, level);
+         for (int l = 0; l < level; ++l) {
+            x->next[l].store(reinterpret_cast<uintptr_t>(succs[l]),
+                             std::memory_order_relaxed);
+         }
+         uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+         if (preds[0][0].compare_exchange_strong(
+                 expected, reinterpret_cast<uintptr_t>(x))) {
+            break;
+         }
+      }
+      __skip_resolve(x->birth);
+      count.fetch_add(1, std::memory_order_relaxed);
+
+      for (int l = 1; l < level; ++l) {
+         for (;;) {
+            uintptr_t succ = x->next[l].load();
+            if (__skip_marked(succ)) goto built;
+            const uintptr_t want = reinterpret_cast<uintptr_t>(succs[l]);
+            if (succ != want &&
+                !x->next[l].compare_exchange_strong(succ, want)) {
+               continue;
+            }
+            uintptr_t expected = want;
+            if (preds[l][l].compare_exchange_strong(
+                    expected, reinterpret_cast<uintptr_t>(x))) {
+               break;
+            }
+            search(key, preds, succs);
+         }
+      }
+   built:
+      // erased while linking, a level linked after the remover's unlink
+      // must come out again
+      if (__skip_marked(x->next[0].load())) unlink_key(key);
+      release(x);
+      return true;
+   }
+
+   bool erase(const K& key) {
+      __epoch_guard guard;
+      link* preds[__skip_max_level];
+      node* succs[__skip_max_level];
+      node* x;
+      for (;;) {
+         search(key, preds, succs);
+         bool removed;
+         x = live_version(succs[0], key, &removed);
+         if (x || !removed) break;
+      }
+      if (!x) return false;
+      __skip_resolve(x->birth);
+      uint64_t alive = 0;
+      if (!x->death.compare_exchange_strong(alive, __skip_pending)) {
+         return false;  // erased by another thread just now
+      }
+      __skip_resolve(x->death);
+      count.fetch_sub(1, std::memory_order_relaxed);
+      if (reclaimable(x)) remove(x);
+      return true;
+   }
+
+   // copies the value of key out, false if it isn't there
+   bool find(const K& key, V& value) const {
+      __epoch_guard guard;
+      node* x = lookup(key);
+      if (x) value = x->data.second;
+      return x != 0;
+   }
+   bool contains(const K& key) const {
+      __epoch_guard guard;
+      return lookup(key) != 0;
+   }
+
+   // unlink the tombstones that no snapshot needs any more; erase leaves
+   // one behind when a snapshot was held at the time
+   void purge() {
+      __epoch_guard guard;
+      for (node* x = ptr(head[0].load()); x; x = ptr(x->next[0].load())) {
+         if (!__skip_marked(x->next[0].load()) && reclaimable(x)) remove(x);
+      }
+   }
+
+   // A consistent view of the list for ordered scans: the elements that
+   // were in it at one point in stamp order, however the list changes while
+   // the snapshot is read.
+   class snapshot {
+     public:
+      explicit snapshot(const concurrent_skip_list& x) : list(&x) {
+         __epoch::pin();
+         stamp = __epoch::begin_snapshot();
+      }
+      ~snapshot() {
+         __epoch::end_snapshot();
+         __epoch::unpin();
+      }
+
+      snapshot(const snapshot&) = delete;
+      snapshot& operator=(const snapshot&) = delete;
+
+      iterator begin() const {
+         return iterator(ptr(list->head[0].load()), stamp);
+      }
+      iterator end() const { return iterator(); }
+      // the first element not before key
+      iterator lower_bound(const K& key) const {
+         const link* pred = list->head;
+         node* cur = 0;
+         for (int l = __skip_max_level - 1; l >= 0; --l) {
+            cur = ptr(pred[l].load());
+            while (cur && list->before(cur, key)) {
+               pred = cur->next;
+               cur = ptr(pred[l].load());
+            }
+         }
+         return iterator(cur, stamp);
+      }
+
+     protected:
+      const concurrent_skip_list* list;
+      uint64_t stamp;
+   };
+};
+}  // namespace tinystl
+
+#endif
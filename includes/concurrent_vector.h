@@ -0,0 +1,245 @@
+#ifndef _CONCURRENT_VECTOR_H_
+#define _CONCURRENT_VECTOR_H_
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+
+namespace tinystl {
+template <class Vector, class T>
+struct __concurrent_vector_iterator
+    : public iterator<random_access_iterator_tag, T, std::ptrdiff_t> {
+   typedef __concurrent_vector_iterator<Vector, T> self;
+   typedef T& reference;
+   typedef std::ptrdiff_t difference_type;
+
+   Vector* v;
+   size_t index;
+
+   __concurrent_vector_iterator() : v(0), index(0) {}
+   __concurrent_vector_iterator(Vector* x, size_t i) : v(x), index(i) {}
+
+   reference operator*() const { return (*v)[index]; }
+   T* operator->() const { return &(operator*()); }
+   reference operator[](difference_type n) const { return (*v)[index + n]; }
+
+   self& operator++() {
+      ++index;
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++index;
+      return tmp;
+   }
+   self& operator--() {
+      --index;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --index;
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      index += n;
+      return *this;
+   }
+   self& operator-=(difference_type n) {
+      index -= n;
+      return *this;
+   }
+   self operator+(difference_type n) const { return self(v, index + n); }
+   self operator-(difference_type n) const { return self(v, index - n); }
+   difference_type operator-(const self& x) const {
+      return static_cast<difference_type>(index - x.index);
+   }
+
+   bool operator==(const self& x) const { return index == x.index; }
+   bool operator!=(const self& x) const { return index != x.index; }
+   bool operator<(const self& x) const { return index < x.index; }
+   bool operator>(const self& x) const { return x < *this; }
+   bool operator<=(const self& x) const { return !(x < *this); }
+   bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+// A vector that many threads can append to at once.
+//
+// The elements live in segments that double in size: segment k holds the
+// first_size << k elements from index (first_size << k) - first_size on, so
+// the segment of an index is the position of the top bit of index +
+// first_size and indexing is a clz and a load. Segments never move, so
+// references stay valid until the vector is destroyed or cleared, and
+// growing never copies an element.
+//
+// push_back and grow_by claim indices with one fetch_add and construct the
+// elements in place. A missing segment is allocated by whichever thread
+// needs it first; a thread that loses the race to publish it frees its own.
+// size() counts claimed indices, so an element another thread is still
+// constructing must be handed over by other means, e.g. by publishing its
+// index. Constructors of T must not throw.
+//
+// The default allocator is thread_alloc, as segments are allocated from
+// whichever thread crosses into them.
+template <class T, class Alloc = thread_alloc>
+class concurrent_vector {
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef value_type& reference;
+   typedef const value_type& const_reference;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef __concurrent_vector_iterator<concurrent_vector, T> iterator;
+   typedef __concurrent_vector_iterator<const concurrent_vector, const T>
+       const_iterator;
+
+  protected:
+   typedef simple_alloc<value_type, Alloc> data_allocator;
+
+   enum { first_log = 3 };
+   enum { first_size = 1 << first_log };
+   enum { segment_count = 64 - first_log };
+
+   std::atomic<pointer> segments[segment_count];
+   std::atomic<size_type> reserved;
+
+   static size_type segment_of(size_type i) {
+      return 63 - __builtin_clzll(static_cast<unsigned long long>(i) +
+                                  first_size) -
+             first_log;
+   }
+   static size_type segment_base(size_type k) {
+      return (size_type(first_size) << k) - first_size;
+   }
+   static size_type segment_size(size_type k) {
+      return size_type(first_size) << k;
+   }
+
+   // the segment k, allocated if it isn't yet
+   pointer segment(size_type k) {
+      pointer p = segments[k].load(std::memory_order_acquire);
+      if (p) return p;
+      pointer fresh = data_allocator::allocate(segment_size(k));
+      if (segments[k].compare_exchange_strong(p, fresh,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+         return fresh;
+      data_allocator::deallocate(fresh, segment_size(k));
+      return p;
+   }
+
+   // construct [first, first + n) from x, segment by segment
+   void fill_range(size_type first, size_type n, const T& x) {
+      while (n > 0) {
+         const size_type k = segment_of(first);
+         const size_type offset = first - segment_base(k);
+         const size_type run = segment_size(k) - offset < n
+                                   ? segment_size(k) - offset
+                                   : n;
+         tinystl::uninitialized_fill_n(segment(k) + offset, run, x);
+         first += run;
+         n -= run;
+      }
+   }
+
+   void destroy_all() {
+      const size_type n = size();
+      for (size_type k = 0; k < segment_count && segment_base(k) < n; ++k) {
+         pointer p = segments[k].load(std::memory_order_relaxed);
+         const size_type end = n - segment_base(k) < segment_size(k)
+                                   ? n - segment_base(k)
+                                   : segment_size(k);
+         tinystl::destroy(p, p + end);
+      }
+   }
+
+  public:
+   concurrent_vector() : reserved(0) {
+      for (size_type k = 0; k < segment_count; ++k) segments[k] = 0;
+   }
+   ~concurrent_vector() {
+      destroy_all();
+      for (size_type k = 0; k < segment_count; ++k) {
+         pointer p = segments[k].load(std::memory_order_relaxed);
+         if (p) data_allocator::deallocate(p, segment_size(k));
+      }
+   }
+
+   concurrent_vector(const concurrent_vector&) = delete;
+   concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+   iterator begin() { return iterator(this, 0); }
+   iterator end() { return iterator(this, size()); }
+   const_iterator begin() const { return const_iterator(this, 0); }
+   const_iterator end() const { return const_iterator(this, size()); }
+
+   // claimed indices, including elements still being constructed
+   size_type size() const { return reserved.load(std::memory_order_acquire); }
+   bool empty() const { return size() == 0; }
+   // elements that fit without allocating
+   size_type capacity() const {
+      size_type k = 0;
+      while (k < segment_count &&
+             segments[k].load(std::memory_order_acquire) != 0)
+         ++k;
+      return segment_base(k);
+   }
+
+   reference operator[](size_type i) {
+      const size_type k = segment_of(i);
+      return segments[k].load(std::memory_order_acquire)[i - segment_base(k)];
+   }
+   const_reference operator[](size_type i) const {
+      const size_type k = segment_of(i);
+      return segments[k].load(std::memory_order_acquire)[i - segment_base(k)];
+   }
+   reference at(size_type i) {
+      assert(i < size() && "concurrent_vector index out of range");
+      return (*this)[i];
+   }
+   reference front() { return (*this)[0]; }
+   reference back() { return (*this)[size() - 1]; }
+
+   // safe to call from many threads, returns the new element
+   iterator push_back(const T& x) {
+      const size_type i = reserved.fetch_add(1, std::memory_order_acq_rel);
+      const size_type k = segment_of(i);
+      tinystl::construct(segment(k) + (i - segment_base(k)), x);
+      return iterator(this, i);
+   }
+   iterator push_back(T&& x) {
+      const size_type i = reserved.fetch_add(1, std::memory_order_acq_rel);
+      const size_type k = segment_of(i);
+      tinystl::construct(segment(k) + (i - segment_base(k)), std::move(x));
+      return iterator(this, i);
+   }
+
+   // append n copies of x as one block of indices, returns the first
+   iterator grow_by(size_type n, const T& x = T()) {
+      const size_type first =
+          reserved.fetch_add(n, std::memory_order_acq_rel);
+      fill_range(first, n, x);
+      return iterator(this, first);
+   }
+
+   // allocate the segments for the first n elements ahead of time
+   void reserve(size_type n) {
+      if (n == 0) return;
+      for (size_type k = 0; k <= segment_of(n - 1); ++k) segment(k);
+   }
+
+   // not concurrent with anything, the segments are kept
+   void clear() {
+      destroy_all();
+      reserved.store(0, std::memory_order_release);
+   }
+};
+}  // namespace tinystl
+
+#endif
@@ -1,18 +1,29 @@
 #ifndef _CONSTRUCT_H_
 #define _CONSTRUCT_H_
 #include <new>
+#include <utility>
+
+#include "instrument.h"
 #include "iterator.h"
 #include "type_traits.h"
 
 namespace tinystl {
+template <class T1>
+inline void construct(T1* p) {
+   new (p) T1();
+   __COUNT_OPS(T1, __op_construct, 1);
+}
+
 template <class T1, class T2>
-inline void construct(T1* p, T2& value) {
-   new (p) T1(value);
+inline void construct(T1* p, T2&& value) {
+   new (p) T1(std::forward<T2>(value));
+   __COUNT_CONSTRUCT(T1, T2);
 }
 
 template <class T>
 inline void destroy(T* p) {
    p->~T();
+   __COUNT_OPS(T, __op_destroy, 1);
 }
 
 // declare
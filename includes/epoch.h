@@ -0,0 +1,187 @@
+#ifndef _EPOCH_H_
+#define _EPOCH_H_
+#include <atomic>
+#include <cstdint>
+
+#include "allocator.h"
+#include "vector.h"
+
+namespace tinystl {
+struct __retired {
+   void* p;
+   void (*deleter)(void*);
+};
+
+// per thread state, never freed: a thread that exits leaves its record
+// and its retired objects to the next thread that starts
+struct __epoch_record {
+   std::atomic<uint64_t> epoch;     // global epoch seen at pin
+   std::atomic<bool> active;        // pinned
+   std::atomic<uint64_t> snapshot;  // oldest snapshot stamp held, or ~0
+   std::atomic<bool> in_use;
+   __epoch_record* next;
+   // owner thread only
+   unsigned depth;
+   unsigned snapshots;
+   uint64_t limbo_epoch[3];
+   vector<__retired, malloc_alloc> limbo[3];
+
+   __epoch_record()
+       : epoch(0),
+         active(false),
+         snapshot(~uint64_t(0)),
+         in_use(true),
+         next(0),
+         depth(0),
+         snapshots(0) {
+      for (int i = 0; i < 3; ++i) limbo_epoch[i] = 0;
+   }
+};
+
+// Epoch based reclamation shared by the lock-free containers.
+//
+// A thread pins itself before it reads shared nodes and unpins after. A
+// node is retired once it can no longer be reached and freed once every
+// thread has been seen unpinned or pinned in a later epoch: the global
+// epoch only moves from e to e + 1 when all pinned threads are in e, so a
+// node retired in e is safe to free in e + 2. Each thread keeps three
+// limbo lists, one per epoch still in flight.
+//
+// The same records publish the oldest snapshot each thread holds, stamped
+// from a global clock, so that a multi-version container can tell which
+// old versions some reader may still need.
+class __epoch {
+  public:
+   enum { collect_threshold = 64 };
+   static const uint64_t no_snapshot = ~uint64_t(0);
+
+  protected:
+   static std::atomic<uint64_t>& global_epoch() {
+      static std::atomic<uint64_t> e(0);
+      return e;
+   }
+   static std::atomic<__epoch_record*>& records() {
+      static std::atomic<__epoch_record*> head(0);
+      return head;
+   }
+
+   static __epoch_record* acquire_record() {
+      for (__epoch_record* r = records().load(); r; r = r->next) {
+         bool expected = false;
+         if (r->in_use.compare_exchange_strong(expected, true)) return r;
+      }
+      __epoch_record* r = new __epoch_record();
+      r->next = records().load();
+      while (!records().compare_exchange_weak(r->next, r)) {
+      }
+      return r;
+   }
+
+   struct local_record {
+      __epoch_record* r;
+
+      local_record() : r(acquire_record()) {}
+      ~local_record() { r->in_use.store(false); }
+   };
+
+   static void free_limbo(__epoch_record* r, int i) {
+      for (size_t k = 0; k < r->limbo[i].size(); ++k) {
+         r->limbo[i][k].deleter(r->limbo[i][k].p);
+      }
+      r->limbo[i].clear();
+   }
+
+   // move the epoch on if every pinned thread has caught up
+   static bool try_advance() {
+      uint64_t e = global_epoch().load();
+      for (__epoch_record* r = records().load(); r; r = r->next) {
+         if (r->in_use.load() && r->active.load() && r->epoch.load() != e) {
+            return false;
+         }
+      }
+      return global_epoch().compare_exchange_strong(e, e + 1);
+   }
+
+  public:
+   static __epoch_record* local() {
+      static thread_local local_record holder;
+      return holder.r;
+   }
+
+   static void pin() {
+      __epoch_record* r = local();
+      if (r->depth++ == 0) {
+         r->active.store(true);
+         r->epoch.store(global_epoch().load());
+      }
+   }
+   static void unpin() {
+      __epoch_record* r = local();
+      if (--r->depth == 0) r->active.store(false, std::memory_order_release);
+   }
+
+   // p is unreachable, call deleter(p) once no thread can hold it
+   static void retire(void* p, void (*deleter)(void*)) {
+      __epoch_record* r = local();
+      const uint64_t e = global_epoch().load();
+      const int i = static_cast<int>(e % 3);
+      // the list last filled in e - 3 or earlier
+      if (r->limbo_epoch[i] != e) {
+         free_limbo(r, i);
+         r->limbo_epoch[i] = e;
+      }
+      __retired x = {p, deleter};
+      r->limbo[i].push_back(x);
+      if (r->limbo[i].size() >= collect_threshold) collect();
+   }
+
+   // advance if possible and free what is two epochs old
+   static void collect() {
+      try_advance();
+      __epoch_record* r = local();
+      const uint64_t e = global_epoch().load();
+      for (int i = 0; i < 3; ++i) {
+         if (r->limbo_epoch[i] + 2 <= e) free_limbo(r, i);
+      }
+   }
+
+   // the global stamp clock for multi-version readers and writers
+   static std::atomic<uint64_t>& clock() {
+      static std::atomic<uint64_t> c(1);
+      return c;
+   }
+
+   // register a snapshot of this thread, returns its stamp
+   static uint64_t begin_snapshot() {
+      __epoch_record* r = local();
+      if (r->snapshots++ == 0) r->snapshot.store(clock().load());
+      // at least the published stamp, so writers that missed the store
+      // stamped their changes before it
+      return clock().load();
+   }
+   static void end_snapshot() {
+      __epoch_record* r = local();
+      if (--r->snapshots == 0) r->snapshot.store(no_snapshot);
+   }
+   // no snapshot held now or taken later is older than this
+   static uint64_t oldest_snapshot() {
+      uint64_t oldest = no_snapshot;
+      for (__epoch_record* r = records().load(); r; r = r->next) {
+         const uint64_t s = r->snapshot.load();
+         if (r->in_use.load() && s < oldest) oldest = s;
+      }
+      return oldest;
+   }
+};
+
+// pins the calling thread for its scope
+struct __epoch_guard {
+   __epoch_guard() { __epoch::pin(); }
+   ~__epoch_guard() { __epoch::unpin(); }
+
+   __epoch_guard(const __epoch_guard&) = delete;
+   __epoch_guard& operator=(const __epoch_guard&) = delete;
+};
+}  // namespace tinystl
+
+#endif
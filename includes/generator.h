@@ -0,0 +1,110 @@
+#ifndef _GENERATOR_H_
+#define _GENERATOR_H_
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include "allocator.h"
+#include "iterator.h"
+#include "ranges.h"
+
+namespace tinystl {
+// A lazily produced sequence, written as a coroutine that co_yields:
+//
+//    generator<int> iota(int n) {
+//       for (int i = 0; i < n; ++i) co_yield i;
+//    }
+//
+// The body runs up to the first co_yield when iteration begins and on to
+// the next one at every increment, so it is an input range; it is a view and
+// can be moved into a pipeline, e.g. iota(100) | views::filter(p). Yielded
+// values are not copied, the iterator refers to the yielded object until the
+// next increment. Frames come from thread_alloc through simple_alloc.
+template <class T>
+class generator : public __view_base {
+  public:
+   struct promise_type;
+   typedef std::coroutine_handle<promise_type> handle_type;
+
+   struct promise_type {
+      const T* value;
+      std::exception_ptr error;
+
+      generator get_return_object() {
+         return generator(handle_type::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend() noexcept { return {}; }
+      std::suspend_always yield_value(const T& x) noexcept {
+         value = std::addressof(x);
+         return {};
+      }
+      void return_void() noexcept {}
+      void unhandled_exception() { error = std::current_exception(); }
+
+      static void* operator new(size_t n) {
+         return simple_alloc<char, thread_alloc>::allocate(n);
+      }
+      static void operator delete(void* p, size_t n) {
+         simple_alloc<char, thread_alloc>::deallocate(static_cast<char*>(p),
+                                                      n);
+      }
+   };
+
+   struct iterator : public tinystl::iterator<input_iterator_tag, T,
+                                               std::ptrdiff_t, const T*,
+                                               const T&> {
+      handle_type h;
+
+      iterator() : h(nullptr) {}
+      explicit iterator(handle_type x) : h(x) {}
+
+      bool done() const { return !h || h.done(); }
+      const T& operator*() const { return *h.promise().value; }
+      const T* operator->() const { return h.promise().value; }
+      iterator& operator++() {
+         resume(h);
+         return *this;
+      }
+      void operator++(int) { ++*this; }
+      bool operator==(const iterator& x) const { return done() == x.done(); }
+      bool operator!=(const iterator& x) const { return !(*this == x); }
+   };
+
+  protected:
+   handle_type h;
+
+   // run to the next co_yield, rethrows what the body threw
+   static void resume(handle_type x) {
+      x.resume();
+      if (x.promise().error) std::rethrow_exception(x.promise().error);
+   }
+
+  public:
+   explicit generator(handle_type x) : h(x) {}
+   generator(generator&& x) : h(x.h) { x.h = nullptr; }
+   generator& operator=(generator&& x) {
+      std::swap(h, x.h);
+      return *this;
+   }
+   ~generator() {
+      if (h) h.destroy();
+   }
+
+   generator(const generator&) = delete;
+   generator& operator=(const generator&) = delete;
+
+   // starts the body, call once
+   iterator begin() {
+      resume(h);
+      return iterator(h);
+   }
+   iterator end() { return iterator(); }
+};
+}  // namespace tinystl
+
+#endif  // __cpp_impl_coroutine
+#endif
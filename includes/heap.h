@@ -0,0 +1,208 @@
+#ifndef _HEAP_H_
+#define _HEAP_H_
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "iterator.h"
+
+// d-ary heap algorithms.
+//
+// Same contract as std::push_heap and friends (the top is the largest
+// element under comp) with the arity as the first template argument, e.g.
+// tinystl::push_heap<2>(first, last) for a binary heap. The default of 4
+// halves the depth of a binary heap and keeps the children of a node in one
+// or two cache lines.
+//
+// pop_heap is bottom-up: the hole left by the top is moved down to a leaf
+// along the larger children without comparing against the element that
+// fills it, which then usually needs no more than a step or two back up.
+
+namespace tinystl {
+enum { __default_heap_arity = 4 };
+
+// move value up from hole, no further than top
+template <size_t D, class RandomAccessIterator, class Distance, class T,
+          class Compare>
+void __push_heap_aux(RandomAccessIterator first, Distance hole, Distance top,
+                     T value, Compare comp) {
+   Distance parent = (hole - 1) / static_cast<Distance>(D);
+   while (hole > top && comp(*(first + parent), value)) {
+      *(first + hole) = std::move(*(first + parent));
+      hole = parent;
+      parent = (hole - 1) / static_cast<Distance>(D);
+   }
+   *(first + hole) = std::move(value);
+}
+
+// move the hole down to a leaf along the larger children, returns the leaf
+template <size_t D, class RandomAccessIterator, class Distance, class Compare>
+Distance __sink_hole(RandomAccessIterator first, Distance hole, Distance len,
+                     Compare comp) {
+   for (;;) {
+      Distance child = static_cast<Distance>(D) * hole + 1;
+      if (child >= len) return hole;
+      Distance last_child = child + static_cast<Distance>(D);
+      if (last_child > len) last_child = len;
+      Distance best = child;
+      for (++child; child < last_child; ++child) {
+         if (comp(*(first + best), *(first + child))) best = child;
+      }
+      *(first + hole) = std::move(*(first + best));
+      hole = best;
+   }
+}
+
+// fill the hole at hole with value, in the subheap rooted at hole
+template <size_t D, class RandomAccessIterator, class Distance, class T,
+          class Compare>
+void __adjust_heap(RandomAccessIterator first, Distance hole, Distance len,
+                   T value, Compare comp) {
+   const Distance top = hole;
+   hole = __sink_hole<D>(first, hole, len, comp);
+   __push_heap_aux<D>(first, hole, top, std::move(value), comp);
+}
+
+template <size_t D, class RandomAccessIterator, class Compare, class T,
+          class Distance>
+inline void __push_heap(RandomAccessIterator first, RandomAccessIterator last,
+                        Compare comp, T*, Distance*) {
+   T value = std::move(*(last - 1));
+   __push_heap_aux<D>(first, Distance(last - first - 1), Distance(0),
+                      std::move(value), comp);
+}
+
+// last - 1 is the new element
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+inline void push_heap(RandomAccessIterator first, RandomAccessIterator last,
+                      Compare comp) {
+   if (last - first < 2) return;
+   __push_heap<D>(first, last, comp, value_type(first), distance_type(first));
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+inline void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   tinystl::push_heap<D>(first, last, std::less<T>());
+}
+
+template <size_t D, class RandomAccessIterator, class Compare, class T,
+          class Distance>
+inline void __pop_heap(RandomAccessIterator first, RandomAccessIterator last,
+                       Compare comp, T*, Distance*) {
+   T value = std::move(*(last - 1));
+   *(last - 1) = std::move(*first);
+   __adjust_heap<D>(first, Distance(0), Distance(last - first - 1),
+                    std::move(value), comp);
+}
+
+// moves the top to last - 1
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare comp) {
+   if (last - first < 2) return;
+   __pop_heap<D>(first, last, comp, value_type(first), distance_type(first));
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   tinystl::pop_heap<D>(first, last, std::less<T>());
+}
+
+template <size_t D, class RandomAccessIterator, class Compare, class T,
+          class Distance>
+void __make_heap(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare comp, T*, Distance*) {
+   const Distance len = last - first;
+   // heapify the subheaps bottom up, O(n) in total
+   for (Distance parent = (len - 2) / static_cast<Distance>(D);; --parent) {
+      T value = std::move(*(first + parent));
+      __adjust_heap<D>(first, parent, len, std::move(value), comp);
+      if (parent == 0) return;
+   }
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+inline void make_heap(RandomAccessIterator first, RandomAccessIterator last,
+                      Compare comp) {
+   if (last - first < 2) return;
+   __make_heap<D>(first, last, comp, value_type(first), distance_type(first));
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+inline void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   tinystl::make_heap<D>(first, last, std::less<T>());
+}
+
+template <size_t D, class RandomAccessIterator, class Compare, class T,
+          class Distance>
+void __update_heap(RandomAccessIterator first, RandomAccessIterator last,
+                   RandomAccessIterator pos, Compare comp, T*, Distance*) {
+   const Distance hole = pos - first;
+   T value = std::move(*pos);
+   const Distance parent = (hole - 1) / static_cast<Distance>(D);
+   if (hole > 0 && comp(*(first + parent), value))
+      __push_heap_aux<D>(first, hole, Distance(0), std::move(value), comp);
+   else
+      __adjust_heap<D>(first, hole, Distance(last - first), std::move(value),
+                       comp);
+}
+
+// restore the heap after the key of *pos changed in either direction
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+inline void update_heap(RandomAccessIterator first, RandomAccessIterator last,
+                        RandomAccessIterator pos, Compare comp) {
+   __update_heap<D>(first, last, pos, comp, value_type(first),
+                    distance_type(first));
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+inline void update_heap(RandomAccessIterator first, RandomAccessIterator last,
+                        RandomAccessIterator pos) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   tinystl::update_heap<D>(first, last, pos, std::less<T>());
+}
+
+// repeatedly pops, leaves the range sorted ascending
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+void sort_heap(RandomAccessIterator first, RandomAccessIterator last,
+               Compare comp) {
+   for (; last - first > 1; --last) tinystl::pop_heap<D>(first, last, comp);
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   tinystl::sort_heap<D>(first, last, std::less<T>());
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator,
+          class Compare>
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last,
+             Compare comp) {
+   typedef typename iterator_traits<RandomAccessIterator>::difference_type
+       Distance;
+   const Distance len = last - first;
+   for (Distance child = 1; child < len; ++child) {
+      if (comp(*(first + (child - 1) / static_cast<Distance>(D)),
+               *(first + child)))
+         return false;
+   }
+   return true;
+}
+
+template <size_t D = __default_heap_arity, class RandomAccessIterator>
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last) {
+   typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+   return tinystl::is_heap<D>(first, last, std::less<T>());
+}
+}  // namespace tinystl
+
+#endif
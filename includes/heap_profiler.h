@@ -0,0 +1,271 @@
+#ifndef _HEAP_PROFILER_H_
+#define _HEAP_PROFILER_H_
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "type_traits.h"
+
+#if defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define __HEAP_PROFILER_BACKTRACE
+#endif
+#endif
+
+namespace tinystl {
+// Sampling heap profiler behind simple_alloc.
+//
+// While running, about one allocation per sample_rate bytes is sampled:
+// every thread counts down an exponentially distributed number of bytes and
+// records the stack of the allocation that crosses zero. Sampled blocks stay
+// in the live heap until they are deallocated, and dump() writes the live
+// heap grouped by call site and element type.
+//
+// When stopped (and no sampled block is alive) simple_alloc pays a single
+// relaxed atomic load per call; define __NO_HEAP_PROFILER to compile the
+// hooks out entirely.
+template <int inst>
+class __heap_profiler {
+  public:
+   enum format { pprof, text };
+   enum { max_depth = 32 };
+
+  private:
+   struct site {
+      std::string type;
+      std::vector<void*> stack;
+      size_t live_objects;
+      size_t live_bytes;
+      size_t alloc_objects;
+      size_t alloc_bytes;
+   };
+   typedef std::pair<const char*, std::vector<void*>> site_key;
+   typedef std::map<site_key, site> site_map;
+   struct sample {
+      size_t bytes;
+      site* owner;
+   };
+
+   static std::atomic<bool> active;  // sampling, or samples still alive
+   static std::atomic<size_t> sample_rate;  // 0 when stopped
+   static size_t profile_rate;  // rate of the samples in the live heap
+   static std::mutex mutex;
+   static thread_local long long bytes_until_sample;
+
+   static site_map& sites() {
+      static site_map* s = new site_map;  // never destroyed
+      return *s;
+   }
+   static std::unordered_map<void*, sample>& live() {
+      static std::unordered_map<void*, sample>* l =
+          new std::unordered_map<void*, sample>;
+      return *l;
+   }
+
+   static long long next_sample_distance(size_t rate) {
+      static thread_local std::minstd_rand engine(static_cast<unsigned>(
+          reinterpret_cast<size_t>(&bytes_until_sample)));
+      std::uniform_real_distribution<double> u(0.0, 1.0);
+      double x = -std::log(1.0 - u(engine)) * static_cast<double>(rate);
+      return static_cast<long long>(x) + 1;
+   }
+
+   // sampled bytes scaled up to an estimate of all allocated bytes
+   static double unsample(size_t bytes, size_t count, size_t rate) {
+      if (bytes == 0 || count == 0 || rate == 0) return 0;
+      double avg = static_cast<double>(bytes) / count;
+      return bytes / (1 - std::exp(-avg / static_cast<double>(rate)));
+   }
+
+   static void write_pprof(std::FILE* out, size_t rate,
+                           const std::vector<const site*>& order) {
+      size_t objects = 0, bytes = 0, alloc_objects = 0, alloc_bytes = 0;
+      for (const site* s : order) {
+         objects += s->live_objects;
+         bytes += s->live_bytes;
+         alloc_objects += s->alloc_objects;
+         alloc_bytes += s->alloc_bytes;
+      }
+      std::fprintf(out, "heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+                   objects, bytes, alloc_objects, alloc_bytes, rate);
+      for (const site* s : order) {
+         std::fprintf(out, "%zu: %zu [%zu: %zu] @", s->live_objects,
+                      s->live_bytes, s->alloc_objects, s->alloc_bytes);
+         for (void* pc : s->stack) std::fprintf(out, " %p", pc);
+         std::fprintf(out, "\n");
+      }
+      // pprof needs the mappings to symbolize the addresses
+      std::fprintf(out, "\nMAPPED_LIBRARIES:\n");
+      if (std::FILE* maps = std::fopen("/proc/self/maps", "r")) {
+         char buf[4096];
+         size_t n;
+         while ((n = std::fread(buf, 1, sizeof(buf), maps)) > 0)
+            std::fwrite(buf, 1, n, out);
+         std::fclose(maps);
+      }
+   }
+
+   static void write_text(std::FILE* out, size_t rate,
+                          const std::vector<const site*>& order) {
+      std::map<std::string, std::pair<double, double>> by_type;
+      double total = 0;
+      for (const site* s : order) {
+         double est = unsample(s->live_bytes, s->live_objects, rate);
+         std::pair<double, double>& t = by_type[__short_type_name(s->type)];
+         t.first += est;
+         t.second += est * s->live_objects / s->live_bytes;
+         total += est;
+      }
+      std::fprintf(out, "tinystl heap profile, sampling every %zu bytes\n",
+                   rate);
+      std::fprintf(out, "estimated live bytes: %.0f\n\nby type:\n", total);
+      for (const auto& t : by_type) {
+         std::fprintf(out, "%14.0f bytes %10.0f objects  %s\n", t.second.first,
+                      t.second.second, t.first.c_str());
+      }
+      std::fprintf(out, "\nby site:\n");
+      for (const site* s : order) {
+         std::fprintf(out, "%14.0f bytes %10zu samples  %s\n",
+                      unsample(s->live_bytes, s->live_objects, rate),
+                      s->live_objects, __short_type_name(s->type).c_str());
+#ifdef __HEAP_PROFILER_BACKTRACE
+         char** symbols = backtrace_symbols(
+             const_cast<void* const*>(s->stack.data()),
+             static_cast<int>(s->stack.size()));
+         for (size_t i = 0; i < s->stack.size(); ++i) {
+            std::fprintf(out, "      #%-2zu %s\n", i,
+                         symbols ? symbols[i] : "?");
+         }
+         std::free(symbols);
+#else
+         for (size_t i = 0; i < s->stack.size(); ++i)
+            std::fprintf(out, "      #%-2zu %p\n", i, s->stack[i]);
+#endif
+      }
+   }
+
+  public:
+   // sample about one allocation per rate bytes
+   static void start(size_t rate = 512 * 1024) {
+      std::lock_guard<std::mutex> guard(mutex);
+      profile_rate = rate ? rate : 1;
+      sample_rate.store(profile_rate, std::memory_order_relaxed);
+      active.store(true, std::memory_order_release);
+   }
+
+   // stop sampling, blocks that are already sampled are still tracked
+   static void stop() {
+      std::lock_guard<std::mutex> guard(mutex);
+      sample_rate.store(0, std::memory_order_relaxed);
+      if (live().empty()) active.store(false, std::memory_order_release);
+   }
+
+   static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+#if defined(__GNUC__) || defined(__clang__)
+   __attribute__((noinline))
+#endif
+   static void record_allocate(void* p, size_t bytes, const char* type) {
+      size_t rate = sample_rate.load(std::memory_order_relaxed);
+      if (0 == p || 0 == rate) return;
+      if (bytes_until_sample <= 0)
+         bytes_until_sample = next_sample_distance(rate);
+      bytes_until_sample -= static_cast<long long>(bytes);
+      if (bytes_until_sample > 0) return;
+      bytes_until_sample = next_sample_distance(rate);
+
+      std::vector<void*> stack;
+#ifdef __HEAP_PROFILER_BACKTRACE
+      void* frames[max_depth + 1];
+      int depth = backtrace(frames, max_depth + 1);
+      // skip the frame of record_allocate, which is never inlined
+      for (int i = 1; i < depth; ++i) stack.push_back(frames[i]);
+#endif
+      std::lock_guard<std::mutex> guard(mutex);
+      site& s = sites()[site_key(type, stack)];
+      if (s.stack.empty() && s.type.empty()) {
+         s.type = type;
+         s.stack = stack;
+      }
+      ++s.live_objects;
+      s.live_bytes += bytes;
+      ++s.alloc_objects;
+      s.alloc_bytes += bytes;
+      sample smp = {bytes, &s};
+      live()[p] = smp;
+   }
+
+   static void record_deallocate(void* p) {
+      std::lock_guard<std::mutex> guard(mutex);
+      std::unordered_map<void*, sample>& l = live();
+      typename std::unordered_map<void*, sample>::iterator it = l.find(p);
+      if (it == l.end()) return;
+      --it->second.owner->live_objects;
+      it->second.owner->live_bytes -= it->second.bytes;
+      l.erase(it);
+      if (l.empty() && 0 == sample_rate.load(std::memory_order_relaxed))
+         active.store(false, std::memory_order_release);
+   }
+
+   // estimated bytes held by live allocations
+   static size_t live_bytes() {
+      std::lock_guard<std::mutex> guard(mutex);
+      double total = 0;
+      for (const auto& s : sites()) {
+         total += unsample(s.second.live_bytes, s.second.live_objects,
+                           profile_rate);
+      }
+      return static_cast<size_t>(total);
+   }
+
+   // write the live heap to path, returns false if the file can't be opened
+   static bool dump(const char* path, format fmt = pprof) {
+      std::FILE* out = std::fopen(path, "w");
+      if (0 == out) return false;
+      std::lock_guard<std::mutex> guard(mutex);
+      std::vector<const site*> order;
+      for (const auto& s : sites()) {
+         if (s.second.live_objects) order.push_back(&s.second);
+      }
+      std::sort(order.begin(), order.end(), [](const site* x, const site* y) {
+         return x->live_bytes > y->live_bytes;
+      });
+      if (fmt == pprof)
+         write_pprof(out, profile_rate, order);
+      else
+         write_text(out, profile_rate, order);
+      std::fclose(out);
+      return true;
+   }
+};
+
+template <int inst>
+std::atomic<bool> __heap_profiler<inst>::active(false);
+
+template <int inst>
+std::atomic<size_t> __heap_profiler<inst>::sample_rate(0);
+
+template <int inst>
+size_t __heap_profiler<inst>::profile_rate = 0;
+
+template <int inst>
+std::mutex __heap_profiler<inst>::mutex;
+
+template <int inst>
+thread_local long long __heap_profiler<inst>::bytes_until_sample = 0;
+
+typedef __heap_profiler<0> heap_profiler;
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef _INSTRUMENT_H_
+#define _INSTRUMENT_H_
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "type_traits.h"
+
+// Opt-in counting of element constructions, copies, moves and destructions.
+//
+// Define __INSTRUMENT_OPS before including any tinystl header to turn it on;
+// otherwise every hook below expands to nothing. Counts are kept per element
+// type and per container operation (the innermost __OP_SCOPE on the thread),
+// e.g. a test can check that list::merge never copies an element:
+//
+//    tinystl::op_counter::reset();
+//    a.merge(b);
+//    assert(tinystl::op_counter::for_op("list::merge").copies == 0);
+//
+// Trivial destructors are not run and therefore not counted.
+
+namespace tinystl {
+struct op_counts {
+   size_t constructions;  // default and converting constructions
+   size_t copies;         // copy constructions and copy assignments
+   size_t moves;          // move constructions and move assignments
+   size_t destructions;
+   size_t bytes_relocated;  // bytes written by copies and moves
+
+   op_counts()
+       : constructions(0),
+         copies(0),
+         moves(0),
+         destructions(0),
+         bytes_relocated(0) {}
+};
+
+enum __op_kind { __op_construct, __op_copy, __op_move, __op_destroy };
+
+// Converts to an rvalue through one function and to an lvalue through
+// another. A T with a move and a copy constructor can't choose between them,
+// so T is constructible from it only when an rvalue runs the copy
+// constructor; the same holds for assignment.
+template <class T>
+struct __rvalue_probe {
+   operator T&&() const;
+   operator T&() const;
+};
+
+// whether "moving" a T runs its copy operations
+template <class T>
+struct __move_is_copy {
+   static const bool construct =
+       std::is_class<T>::value &&
+       std::is_constructible<T, __rvalue_probe<T>>::value;
+   static const bool assign = std::is_class<T>::value &&
+                              std::is_assignable<T&, __rvalue_probe<T>>::value;
+};
+
+template <int inst>
+class __op_counter {
+  private:
+   static std::mutex mutex;
+   static thread_local const char* current_op;
+
+   static std::map<std::string, op_counts>& types() {
+      static std::map<std::string, op_counts>* t =
+          new std::map<std::string, op_counts>;
+      return *t;
+   }
+   static std::map<std::string, op_counts>& ops() {
+      static std::map<std::string, op_counts>* o =
+          new std::map<std::string, op_counts>;
+      return *o;
+   }
+
+   static void add(op_counts& c, __op_kind kind, size_t n, size_t bytes) {
+      switch (kind) {
+         case __op_construct:
+            c.constructions += n;
+            break;
+         case __op_copy:
+            c.copies += n;
+            c.bytes_relocated += bytes;
+            break;
+         case __op_move:
+            c.moves += n;
+            c.bytes_relocated += bytes;
+            break;
+         case __op_destroy:
+            c.destructions += n;
+            break;
+      }
+   }
+
+   static void print(std::ostream& out, const std::string& name,
+                     const op_counts& c) {
+      out << name << ": " << c.constructions << " constructed, " << c.copies
+          << " copied, " << c.moves << " moved, " << c.destructions
+          << " destroyed, " << c.bytes_relocated << " bytes relocated\n";
+   }
+
+  public:
+   static void record(const char* type, __op_kind kind, size_t n,
+                      size_t bytes) {
+      std::lock_guard<std::mutex> guard(mutex);
+      add(types()[__short_type_name(type)], kind, n, bytes);
+      add(ops()[current_op ? current_op : "(no operation)"], kind, n, bytes);
+   }
+
+   template <class T>
+   static void record(__op_kind kind, size_t n) {
+      record(__type_name<T>(), kind, n, n * sizeof(T));
+   }
+
+   // classify new (p) T(std::forward<Arg>(arg))
+   template <class T, class Arg>
+   static void record_construct() {
+      typedef typename std::decay<Arg>::type source;
+      if (!std::is_same<source, T>::value)
+         record<T>(__op_construct, 1);
+      else if (std::is_rvalue_reference<Arg&&>::value &&
+               !__move_is_copy<T>::construct)
+         record<T>(__op_move, 1);
+      else
+         record<T>(__op_copy, 1);
+   }
+
+   static const char* enter(const char* op) {
+      const char* previous = current_op;
+      current_op = op;
+      return previous;
+   }
+   static void leave(const char* previous) { current_op = previous; }
+
+   // e.g. for_type("int"), for_type(__short_type_name(__type_name<T>()))
+   static op_counts for_type(const std::string& type) {
+      std::lock_guard<std::mutex> guard(mutex);
+      std::map<std::string, op_counts>::iterator it = types().find(type);
+      return it == types().end() ? op_counts() : it->second;
+   }
+   template <class T>
+   static op_counts for_type() {
+      return for_type(__short_type_name(__type_name<T>()));
+   }
+
+   // e.g. for_op("vector::insert_aux")
+   static op_counts for_op(const std::string& op) {
+      std::lock_guard<std::mutex> guard(mutex);
+      std::map<std::string, op_counts>::iterator it = ops().find(op);
+      return it == ops().end() ? op_counts() : it->second;
+   }
+
+   static void reset() {
+      std::lock_guard<std::mutex> guard(mutex);
+      types().clear();
+      ops().clear();
+   }
+
+   static void report(std::ostream& out) {
+      std::lock_guard<std::mutex> guard(mutex);
+      out << "by type:\n";
+      for (const auto& t : types()) print(out, "   " + t.first, t.second);
+      out << "by operation:\n";
+      for (const auto& o : ops()) print(out, "   " + o.first, o.second);
+   }
+};
+
+template <int inst>
+std::mutex __op_counter<inst>::mutex;
+
+template <int inst>
+thread_local const char* __op_counter<inst>::current_op = 0;
+
+typedef __op_counter<0> op_counter;
+
+// attributes the counts of its lifetime to a container operation
+class __op_scope {
+  private:
+   const char* previous;
+
+  public:
+   explicit __op_scope(const char* op) : previous(op_counter::enter(op)) {}
+   ~__op_scope() { op_counter::leave(previous); }
+};
+}  // namespace tinystl
+
+// every hook takes a semicolon; __OP_SCOPE declares a guard that lasts to
+// the end of the enclosing block
+#ifdef __INSTRUMENT_OPS
+#define __OP_SCOPE(name) tinystl::__op_scope __op_scope_guard(name)
+#define __COUNT_CONSTRUCT(T, Arg)                      \
+   do {                                                \
+      tinystl::op_counter::record_construct<T, Arg>(); \
+   } while (0)
+#define __COUNT_OPS(T, kind, n)                \
+   do {                                        \
+      tinystl::op_counter::record<T>(kind, n); \
+   } while (0)
+#else
+#define __OP_SCOPE(name)
+#define __COUNT_CONSTRUCT(T, Arg) \
+   do {                           \
+   } while (0)
+#define __COUNT_OPS(T, kind, n) \
+   do {                         \
+   } while (0)
+#endif
+
+#endif
@@ -80,7 +80,7 @@ template <class RandomAccessIterator>
 inline typename iterator_traits<RandomAccessIterator>::difference_type
 __distance(RandomAccessIterator first, RandomAccessIterator last,
            random_access_iterator_tag) {
-   return first - last;
+   return last - first;
 }
 
 template <class InputIterator>
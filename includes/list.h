@@ -1,8 +1,11 @@
 #ifndef _LIST_H_
 #define _LIST_H_
 #include <cassert>
+#include <cstdint>
 #include <type_traits>
 
+#include "algobase.h"
+#include "algorithm.h"
 #include "allocator.h"
 #include "construct.h"
 #include "iterator.h"
@@ -20,7 +23,7 @@ template <class T>
 struct __list_iterator : public iterator<bidirectional_iterator_tag, T> {
    typedef __list_iterator<T> self;
    typedef __list_node<T>* link_type;
-   typedef iterator<bidirectional_iterator_tag, T> iterator;
+   typedef tinystl::iterator<bidirectional_iterator_tag, T> iterator;
 
    link_type node;
 
@@ -49,15 +52,43 @@ struct __list_iterator : public iterator<bidirectional_iterator_tag, T> {
    self operator--(int) {
       self temp = *this;
       --*this;
-      return *this;
+      return temp;
    }
 };
 
+inline void __prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+   __builtin_prefetch(p);
+#else
+   (void)p;
+#endif
+}
+
+// relink the nodes [first, last) before pos, pos must not be in the range
+template <class T>
+inline void __list_transfer(__list_node<T>* pos, __list_node<T>* first,
+                            __list_node<T>* last) {
+   if (pos != last) {
+      last->prev->next = pos;
+      first->prev->next = last;
+      pos->prev->next = first;
+      __list_node<T>* temp = pos->prev;
+      pos->prev = last->prev;
+      last->prev = first->prev;
+      first->prev = temp;
+   }
+}
+
+struct __container_io;
+
 template <class T, class Alloc = alloc>
 class list {
+   friend struct __container_io;
+
   protected:
    typedef __list_node<T> list_node;
    typedef simple_alloc<list_node, Alloc> list_node_allocator;
+   typedef simple_alloc<list_node*, Alloc> link_array_allocator;
    typedef list<T, Alloc> self;
 
   public:
@@ -74,12 +105,25 @@ class list {
 
   public:
    list() { empty_init(); }
+   list(size_type n, const T& value) {
+      empty_init();
+      fill_insert(end(), n, value);
+   }
+   explicit list(size_type n) {
+      empty_init();
+      fill_insert(end(), n, T());
+   }
+   template <class InputIterator>
+   list(InputIterator first, InputIterator last) {
+      empty_init();
+      insert(end(), first, last);
+   }
    iterator begin() const { return node->next; }
    iterator end() const { return node; }
    bool empty() const { return node->next == node; }
    size_type size() const {
       size_type result = 0;
-      result = static_cast<size_type>(distance(begin(), end()));
+      result = static_cast<size_type>(tinystl::distance(begin(), end()));
       return result;
    }
    reference front() { return *begin(); }
@@ -98,8 +142,87 @@ class list {
       put_node(p);
    }
 
+   // n nodes from one allocator round trip, construct_at(&data) builds
+   // each in order, linked from the result to tail
+   template <class Construct>
+   link_type create_run(size_type n, Construct construct_at, link_type& tail) {
+      link_type head = list_node_allocator::allocate_n(n);
+      link_type p = head;
+      size_type built = 0;
+      try {
+         for (; built < n; ++built) {
+            construct_at(&(p->data));
+            p = list_node_allocator::next_in_chain(p);
+         }
+      } catch (...) {
+         for (p = head; built > 0; --built) {
+            destroy(&(p->data));
+            p = list_node_allocator::next_in_chain(p);
+         }
+         list_node_allocator::deallocate_n(head, n);
+         throw;
+      }
+      // the chain runs through prev, turn it into next and prev links
+      link_type last = 0;
+      for (p = head; p != 0;) {
+         link_type next = list_node_allocator::next_in_chain(p);
+         p->prev = last;
+         if (last) last->next = p;
+         last = p;
+         p = next;
+      }
+      tail = last;
+      return head;
+   }
+   // link the run [head, tail] before pos
+   static void link_run(link_type pos, link_type head, link_type tail) {
+      head->prev = pos->prev;
+      tail->next = pos;
+      pos->prev->next = head;
+      pos->prev = tail;
+   }
+
+   void fill_insert(iterator pos, size_type n, const T& x) {
+      if (n == 0) return;
+      link_type tail;
+      link_type head =
+          create_run(n, [&x](T* p) { construct(p, x); }, tail);
+      link_run(pos.node, head, tail);
+   }
+   template <class Integer>
+   void insert_dispatch(iterator pos, Integer n, Integer x, _true_type) {
+      fill_insert(pos, static_cast<size_type>(n), x);
+   }
+   template <class InputIterator>
+   void insert_dispatch(iterator pos, InputIterator first, InputIterator last,
+                        _false_type) {
+      range_insert(pos, first, last, iterator_category(first));
+   }
+   template <class InputIterator>
+   void range_insert(iterator pos, InputIterator first, InputIterator last,
+                     input_iterator_tag) {
+      for (; first != last; ++first) insert(pos, *first);
+   }
+   // length known up front, a single allocator round trip
+   template <class ForwardIterator>
+   void range_insert(iterator pos, ForwardIterator first,
+                     ForwardIterator last, forward_iterator_tag) {
+      size_type n = static_cast<size_type>(tinystl::distance(first, last));
+      if (n == 0) return;
+      link_type tail;
+      link_type head = create_run(
+          n,
+          [&first](T* p) {
+             construct(p, *first);
+             ++first;
+          },
+          tail);
+      link_run(pos.node, head, tail);
+   }
+
   public:
    iterator insert(iterator pos, const T& x) {
+      __OP_SCOPE("list::insert");
       link_type new_node = create_node(x);
       new_node->prev = pos.node->prev;
       new_node->next = pos.node;
@@ -108,10 +231,22 @@ class list {
       return iterator(new_node);
    }
 
+   void insert(iterator pos, size_type n, const T& x) {
+      __OP_SCOPE("list::insert");
+      fill_insert(pos, n, x);
+   }
+   template <class InputIterator>
+   void insert(iterator pos, InputIterator first, InputIterator last) {
+      __OP_SCOPE("list::insert");
+      typedef typename _is_integer<InputIterator>::integral integral;
+      insert_dispatch(pos, first, last, integral());
+   }
+
    void push_front(const T& x) { insert(begin(), x); }
    void push_back(const T& x) { insert(end(), x); }
 
    iterator erase(iterator pos) {
+      __OP_SCOPE("list::erase");
       link_type next_node = pos.node->next;
       link_type prev_node = pos.node->prev;
       prev_node->next = next_node;
@@ -189,6 +324,7 @@ class list {
    }
 
    void merge(self& x) {
+      __OP_SCOPE("list::merge");
       iterator first1 = begin();
       iterator last1 = end();
       iterator first2 = x.begin();
@@ -219,6 +355,7 @@ class list {
    }
 
    void sort(iterator first, iterator last) {
+      __OP_SCOPE("list::sort");
       if (first != last && first.node->next != last.node) {
          iterator p = partition(first, last);
          sort(first, p);
@@ -226,6 +363,72 @@ class list {
       }
    }
 
+   // Moves the elements, in order, into nodes from one allocator round trip
+   // laid out by ascending address, then frees the old nodes in bulk, so
+   // that iteration walks memory forward again after heavy churn. The new
+   // nodes reuse free blocks of the pool before fresh ones. Invalidates
+   // all iterators, pointers and references to the elements.
+   void compact() {
+      __OP_SCOPE("list::compact");
+      const size_type n = size();
+      if (n == 0) return;
+      link_type* fresh = link_array_allocator::allocate(n);
+      link_type chain = list_node_allocator::allocate_n(n);
+      for (size_type i = 0; i < n; ++i) {
+         fresh[i] = chain;
+         chain = list_node_allocator::next_in_chain(chain);
+      }
+      sort_by_address(fresh, n);
+      size_type built = 0;
+      try {
+         for (link_type p = node->next; p != node; p = p->next, ++built) {
+            construct(&(fresh[built]->data), std::move_if_noexcept(p->data));
+         }
+      } catch (...) {
+         for (size_type i = 0; i < built; ++i) destroy(&(fresh[i]->data));
+         for (size_type i = 0; i + 1 < n; ++i) fresh[i]->prev = fresh[i + 1];
+         fresh[n - 1]->prev = 0;
+         list_node_allocator::deallocate_n(fresh[0], n);
+         link_array_allocator::deallocate(fresh, n);
+         throw;
+      }
+      // chain the old nodes through prev and free them in one go
+      link_type old = node->next;
+      for (link_type p = old; p != node; p = p->next) {
+         destroy(&(p->data));
+         p->prev = p->next != node ? p->next : 0;
+      }
+      list_node_allocator::deallocate_n(old, n);
+      link_in_order(fresh, n);
+      link_array_allocator::deallocate(fresh, n);
+   }
+
+   // Relinks the nodes in address order without moving any element, for
+   // lists whose order does not matter. The elements end up in address
+   // order; iterators, pointers and references stay valid.
+   void relink_by_address() {
+      __OP_SCOPE("list::relink_by_address");
+      const size_type n = size();
+      if (n < 2) return;
+      link_type* nodes = link_array_allocator::allocate(n);
+      size_type i = 0;
+      for (link_type p = node->next; p != node; p = p->next) nodes[i++] = p;
+      sort_by_address(nodes, n);
+      link_in_order(nodes, n);
+      link_array_allocator::deallocate(nodes, n);
+   }
+
+   // Calls f on each element in order while the node after the next one
+   // is prefetched, for scattered lists that cannot be compacted.
+   template <class Function>
+   Function for_each(Function f) {
+      for (link_type p = node->next; p != node; p = p->next) {
+         __prefetch(p->next->next);
+         f(p->data);
+      }
+      return f;
+   }
+
    void _traversal() {
       for (iterator it = begin(); it != end(); ++it) {
          std::cout << (it == begin() ? "" : " ") << *it;
@@ -240,16 +443,33 @@ class list {
       node->prev = node;
    }
 
-   void transfer(iterator pos, iterator first, iterator last) {
-      if (pos != last) {
-         last.node->prev->next = pos.node;
-         first.node->prev->next = last.node;
-         pos.node->prev->next = first.node;
-         link_type temp = pos.node->prev;
-         pos.node->prev = last.node->prev;
-         last.node->prev = first.node->prev;
-         first.node->prev = temp;
+   static void sort_by_address(link_type* nodes, size_type n) {
+      tinystl::sort_by_key(nodes, nodes + n, [](link_type p) {
+         return reinterpret_cast<uintptr_t>(p);
+      });
+   }
+   // make nodes[0, n) the whole list, in that order
+   void link_in_order(link_type* nodes, size_type n) {
+      link_type prev = node;
+      for (size_type i = 0; i < n; ++i) {
+         nodes[i]->prev = prev;
+         prev->next = nodes[i];
+         prev = nodes[i];
       }
+      prev->next = node;
+      node->prev = prev;
+   }
+
+   void transfer(iterator pos, iterator first, iterator last) {
+      __list_transfer(pos.node, first.node, last.node);
+   }
+
+   // std::swap is one construction and two assignments from rvalues, they
+   // run the copy operations of a T without move operations
+   void swap_data(link_type x, link_type y) {
+      std::swap(x->data, y->data);
+      __COUNT_OPS(T, __move_is_copy<T>::construct ? __op_copy : __op_move, 1);
+      __COUNT_OPS(T, __move_is_copy<T>::assign ? __op_copy : __op_move, 2);
    }
 
    iterator partition(iterator first, iterator last) {
@@ -260,13 +480,41 @@ class list {
       for (iterator j = first; j != pivot; ++j) {
          if (j.node->data < pivot.node->data) {
             ++i;
-            std::swap(j.node->data, i.node->data);
+            swap_data(j.node, i.node);
          }
       }
       ++i;
-      std::swap(i.node->data, pivot.node->data);
+      swap_data(i.node, pivot.node);
       return i;
    }
 };
-#endif
-}  // namespace tinystl
\ No newline at end of file
+
+// Node-aware overloads of the algobase.h algorithms. They relink nodes
+// instead of assigning elements, so iterators keep following their elements
+// and nothing is copied.
+
+// [middle, last) is moved before first, returns first as in std::rotate
+template <class T>
+inline __list_iterator<T> rotate(__list_iterator<T> first,
+                                 __list_iterator<T> middle,
+                                 __list_iterator<T> last) {
+   if (first == middle) return last;
+   if (middle == last) return first;
+   __list_transfer(first.node, middle.node, last.node);
+   return first;
+}
+
+template <class T>
+void reverse(__list_iterator<T> first, __list_iterator<T> last) {
+   if (first == last) return;
+   __list_iterator<T> next = first;
+   // move each following node to the front of the range
+   for (++next; next != last;) {
+      __list_iterator<T> old = next++;
+      __list_transfer(first.node, old.node, next.node);
+      first = old;
+   }
+}
+}  // namespace tinystl
+
+#endif
\ No newline at end of file
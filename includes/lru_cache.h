@@ -0,0 +1,284 @@
+#ifndef _LRU_CACHE_H_
+#define _LRU_CACHE_H_
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "list.h"
+
+namespace tinystl {
+// plain LRU: one recency list
+struct lru_policy {
+   enum { segmented = false };
+};
+// segmented LRU: new entries start on probation and a second hit moves
+// them to a protected segment of 4/5 of the capacity, so one scan cannot
+// flush the entries that are used again and again
+struct slru_policy {
+   enum { segmented = true };
+};
+
+template <class K, class V>
+struct __lru_entry {
+   K key;
+   V value;
+   size_t hash;
+   size_t bytes;
+   __list_node<__lru_entry>* chain;  // next in the hash bucket
+   int segment;                      // 0 probation, 1 protected
+
+   __lru_entry(const K& k, const V& v, size_t h, size_t b)
+       : key(k), value(v), hash(h), bytes(b), chain(0), segment(0) {}
+};
+
+// A fixed capacity key-value cache that evicts the least recently used
+// entries.
+//
+// Every entry is one __list_node from Alloc that is linked into a recency
+// list and, through its chain pointer, into a bucket of the hash index, so
+// an insert is one pooled allocation and a hit is a bucket walk and a
+// __list_transfer to the front. The index has a power of two buckets sized
+// for the capacity up front.
+//
+// Entries are evicted from the back of the list when there are more than
+// capacity() of them or, if a byte budget is set, when the bytes given to
+// put add up to more than it. evict(n) drops a batch at once. hits(),
+// misses() and evictions() count what get and put did.
+template <class K, class V, class Hash = std::hash<K>,
+          class Policy = lru_policy, class Alloc = alloc>
+class lru_cache {
+  public:
+   typedef K key_type;
+   typedef V mapped_type;
+   typedef size_t size_type;
+
+  protected:
+   typedef __lru_entry<K, V> entry;
+   typedef __list_node<entry> node;
+   typedef simple_alloc<node, Alloc> node_allocator;
+   typedef simple_alloc<node*, Alloc> bucket_allocator;
+
+   node* heads[2];  // sentinels, 0 probation or the only list, 1 protected
+   node** buckets;
+   size_type bucket_log;
+   size_type count;
+   size_type protected_count;
+   size_type max_count;
+   size_type total_bytes;
+   size_type max_bytes;  // 0 for no byte budget
+   size_type hit_count;
+   size_type miss_count;
+   size_type eviction_count;
+   Hash hasher;
+
+   size_type bucket_count() const { return size_type(1) << bucket_log; }
+   size_type bucket_of(size_t h) const {
+      return static_cast<size_type>((h * 0x9E3779B97F4A7C15ull) >>
+                                    (64 - bucket_log));
+   }
+
+   node* find_node(const K& key, size_t h) const {
+      node* x = buckets[bucket_of(h)];
+      while (x && !(x->data.hash == h && x->data.key == key)) {
+         x = x->data.chain;
+      }
+      return x;
+   }
+   void index_insert(node* x) {
+      node** slot = buckets + bucket_of(x->data.hash);
+      x->data.chain = *slot;
+      *slot = x;
+   }
+   void index_erase(node* x) {
+      node** slot = buckets + bucket_of(x->data.hash);
+      while (*slot != x) slot = &(*slot)->data.chain;
+      *slot = x->data.chain;
+   }
+   void rehash(size_type new_log) {
+      node** old = buckets;
+      const size_type old_count = bucket_count();
+      buckets = bucket_allocator::allocate(size_type(1) << new_log);
+      bucket_log = new_log;
+      for (size_type i = 0; i < bucket_count(); ++i) buckets[i] = 0;
+      for (size_type i = 0; old && i < old_count; ++i) {
+         for (node* x = old[i]; x;) {
+            node* next = x->data.chain;
+            index_insert(x);
+            x = next;
+         }
+      }
+      if (old) bucket_allocator::deallocate(old, old_count);
+   }
+
+   static node* new_sentinel() {
+      node* x = node_allocator::allocate();
+      x->prev = x->next = x;
+      return x;
+   }
+   // move x to the front of list k
+   void push_front(node* x, int k) {
+      if (heads[k]->next != x) __list_transfer(heads[k]->next, x, x->next);
+   }
+   static void unlink(node* x) {
+      x->prev->next = x->next;
+      x->next->prev = x->prev;
+   }
+
+   void promote(node* x) {
+      if (!Policy::segmented || x->data.segment == 1) {
+         push_front(x, x->data.segment);
+         return;
+      }
+      x->data.segment = 1;
+      ++protected_count;
+      push_front(x, 1);
+      if (protected_count > protected_capacity()) {
+         // demote the coldest protected entry back to probation
+         node* y = heads[1]->prev;
+         y->data.segment = 0;
+         --protected_count;
+         push_front(y, 0);
+      }
+   }
+
+   void destroy_node(node* x) {
+      unlink(x);
+      index_erase(x);
+      if (x->data.segment == 1) --protected_count;
+      total_bytes -= x->data.bytes;
+      --count;
+      tinystl::destroy(&x->data);
+      node_allocator::deallocate(x);
+   }
+
+   node* victim() const {
+      return heads[0]->prev != heads[0] ? heads[0]->prev : heads[1]->prev;
+   }
+   bool over_budget() const {
+      return count > max_count || (max_bytes != 0 && total_bytes > max_bytes);
+   }
+
+  public:
+   // capacity in entries, and a byte budget over the bytes given to put
+   explicit lru_cache(size_type capacity, size_type byte_budget = 0)
+       : buckets(0),
+         bucket_log(0),
+         count(0),
+         protected_count(0),
+         max_count(capacity),
+         total_bytes(0),
+         max_bytes(byte_budget),
+         hit_count(0),
+         miss_count(0),
+         eviction_count(0) {
+      heads[0] = new_sentinel();
+      heads[1] = new_sentinel();
+      size_type log = 3;
+      while ((size_type(1) << log) < capacity) ++log;
+      rehash(log);
+   }
+   ~lru_cache() {
+      clear();
+      node_allocator::deallocate(heads[0]);
+      node_allocator::deallocate(heads[1]);
+      bucket_allocator::deallocate(buckets, bucket_count());
+   }
+
+   lru_cache(const lru_cache&) = delete;
+   lru_cache& operator=(const lru_cache&) = delete;
+
+   size_type size() const { return count; }
+   bool empty() const { return count == 0; }
+   size_type capacity() const { return max_count; }
+   size_type protected_capacity() const { return max_count * 4 / 5; }
+   size_type bytes() const { return total_bytes; }
+   size_type byte_budget() const { return max_bytes; }
+
+   size_type hits() const { return hit_count; }
+   size_type misses() const { return miss_count; }
+   size_type evictions() const { return eviction_count; }
+   void reset_stats() { hit_count = miss_count = eviction_count = 0; }
+
+   // the value of key marked as just used, null on a miss
+   V* get(const K& key) {
+      node* x = find_node(key, hasher(key));
+      if (!x) {
+         ++miss_count;
+         return 0;
+      }
+      ++hit_count;
+      promote(x);
+      return &x->data.value;
+   }
+   // looks without touching the recency order or the counters
+   const V* peek(const K& key) const {
+      node* x = find_node(key, hasher(key));
+      return x ? &x->data.value : 0;
+   }
+   bool contains(const K& key) const { return peek(key) != 0; }
+
+   // insert or replace, then evict down to the budgets
+   void put(const K& key, const V& value, size_type bytes = 0) {
+      const size_t h = hasher(key);
+      node* x = find_node(key, h);
+      if (x) {
+         x->data.value = value;
+         total_bytes = total_bytes - x->data.bytes + bytes;
+         x->data.bytes = bytes;
+         promote(x);
+      } else {
+         x = node_allocator::allocate();
+         try {
+            tinystl::construct(&x->data, entry(key, value, h, bytes));
+         } catch (...) {
+            node_allocator::deallocate(x);
+            throw;
+         }
+         x->prev = heads[0];
+         x->next = heads[0]->next;
+         heads[0]->next->prev = x;
+         heads[0]->next = x;
+         index_insert(x);
+         ++count;
+         total_bytes += bytes;
+         if (count > bucket_count()) rehash(bucket_log + 1);
+      }
+      while (over_budget() && count > 1) {
+         destroy_node(victim());
+         ++eviction_count;
+      }
+   }
+
+   bool erase(const K& key) {
+      node* x = find_node(key, hasher(key));
+      if (!x) return false;
+      destroy_node(x);
+      return true;
+   }
+
+   // drop the n least recently used entries
+   void evict(size_type n) {
+      for (; n > 0 && count > 0; --n) {
+         destroy_node(victim());
+         ++eviction_count;
+      }
+   }
+   // change the budgets, evicting what no longer fits in one batch
+   void resize(size_type capacity, size_type byte_budget = 0) {
+      max_count = capacity;
+      max_bytes = byte_budget;
+      while (over_budget() && count > 0) {
+         destroy_node(victim());
+         ++eviction_count;
+      }
+   }
+
+   void clear() {
+      while (count > 0) destroy_node(victim());
+   }
+};
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef _MAPPED_VECTOR_H_
+#define _MAPPED_VECTOR_H_
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "alloc.h"
+
+namespace tinystl {
+// A vector whose elements live in a memory-mapped file.
+//
+// The file is a plain array of T without any header, so opening a dataset
+// costs one mmap and no copy; pages are read on first touch. Growing a
+// read_write vector extends the file and remaps it (mremap on Linux), and
+// close() trims the file back to size() elements. A copy_on_write vector
+// never writes to the file: writes land in private pages, and growing it
+// moves the contents into anonymous memory.
+//
+// POSIX only. Iterators and references are invalidated by any growth.
+template <class T>
+class mapped_vector {
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "mapped_vector needs a trivially copyable value type");
+
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef value_type* iterator;
+   typedef const value_type* const_iterator;
+   typedef value_type& reference;
+   typedef const value_type& const_reference;
+   typedef size_t size_type;
+   typedef ptrdiff_t difference_type;
+
+   enum mode { read_only, read_write, copy_on_write };
+   enum access_hint { normal, sequential, random, will_need };
+
+  protected:
+   int fd;
+   mode map_mode;
+   iterator start, finish, end_of_storage;
+
+   size_type mapped_bytes() const {
+      return (end_of_storage - start) * sizeof(T);
+   }
+
+   void unmap() {
+      if (start) munmap(start, mapped_bytes());
+      start = finish = end_of_storage = 0;
+   }
+
+   static iterator map_file(int fd, size_type bytes, mode m) {
+      int prot = m == read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+      int flags = m == read_write ? MAP_SHARED : MAP_PRIVATE;
+      void* p = mmap(0, bytes, prot, flags, fd, 0);
+      return p == MAP_FAILED ? 0 : static_cast<iterator>(p);
+   }
+
+   // move the elements into a larger mapping, capacity in elements
+   void remap(size_type len) {
+      const size_type old_size = size();
+      const size_type new_bytes = len * sizeof(T);
+      iterator new_start = 0;
+      if (map_mode == read_write) {
+         if (ftruncate(fd, static_cast<off_t>(new_bytes)) != 0) {
+            __THROW_BAD_ALLOC;
+         }
+#ifdef MREMAP_MAYMOVE
+         if (start) {
+            void* p = mremap(start, mapped_bytes(), new_bytes, MREMAP_MAYMOVE);
+            new_start = p == MAP_FAILED ? 0 : static_cast<iterator>(p);
+         } else {
+            new_start = map_file(fd, new_bytes, map_mode);
+         }
+#else
+         unmap();
+         new_start = map_file(fd, new_bytes, map_mode);
+#endif
+      } else {
+         // private pages can't outgrow the file, copy into anonymous memory
+         void* p = mmap(0, new_bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+         if (p != MAP_FAILED) {
+            new_start = static_cast<iterator>(p);
+            if (old_size) std::memcpy(new_start, start, old_size * sizeof(T));
+            unmap();
+         }
+      }
+      if (0 == new_start) {
+         __THROW_BAD_ALLOC;
+      }
+      start = new_start;
+      finish = new_start + old_size;
+      end_of_storage = new_start + len;
+   }
+
+  public:
+   mapped_vector()
+       : fd(-1), map_mode(read_only), start(0), finish(0), end_of_storage(0) {}
+   mapped_vector(const char* path, mode m) : mapped_vector() {
+      open(path, m);
+   }
+   ~mapped_vector() { close(); }
+
+   mapped_vector(const mapped_vector&) = delete;
+   mapped_vector& operator=(const mapped_vector&) = delete;
+
+   // map an existing file, read_write creates it when it doesn't exist
+   bool open(const char* path, mode m = read_only) {
+      close();
+      int flags = m == read_write ? O_RDWR | O_CREAT : O_RDONLY;
+      fd = ::open(path, flags, 0644);
+      if (fd < 0) return false;
+      struct stat st;
+      if (fstat(fd, &st) != 0 || st.st_size % sizeof(T) != 0) {
+         close();
+         return false;
+      }
+      map_mode = m;
+      const size_type n = static_cast<size_type>(st.st_size) / sizeof(T);
+      if (n) {
+         start = map_file(fd, n * sizeof(T), m);
+         if (0 == start) {
+            close();
+            return false;
+         }
+         finish = end_of_storage = start + n;
+      }
+      return true;
+   }
+
+   // unmap, and trim the file to size() when it was extended
+   void close() {
+      if (start && map_mode == read_write) {
+         msync(start, size() * sizeof(T), MS_SYNC);
+      }
+      const size_type n = size();
+      const bool trim = map_mode == read_write && capacity() != n;
+      unmap();
+      if (fd >= 0) {
+         // on failure the file keeps a zeroed tail
+         if (trim) ftruncate(fd, static_cast<off_t>(n * sizeof(T)));
+         ::close(fd);
+      }
+      fd = -1;
+   }
+
+   bool is_open() const { return fd >= 0; }
+   iterator begin() const { return start; }
+   iterator end() const { return finish; }
+   pointer data() const { return start; }
+   size_type size() const { return static_cast<size_type>(finish - start); }
+   size_type capacity() const {
+      return static_cast<size_type>(end_of_storage - start);
+   }
+   bool empty() const { return start == finish; }
+   reference operator[](size_type n) const { return *(start + n); }
+   reference front() const { return *start; }
+   reference back() const { return *(finish - 1); }
+
+   void reserve(size_type n) {
+      assert(map_mode != read_only && "mapped_vector is read only");
+      if (n > capacity()) remap(n);
+   }
+
+   void push_back(const T& x) {
+      if (finish == end_of_storage) {
+         const size_type old_sz = size();
+         // start with about a page
+         const size_type page = (4096 + sizeof(T) - 1) / sizeof(T);
+         reserve(old_sz != 0 ? 2 * old_sz : page);
+      }
+      *finish = x;
+      ++finish;
+   }
+
+   void pop_back() { --finish; }
+
+   void resize(size_type n) {
+      reserve(n);
+      // a freshly extended file reads as zeros, old elements may not
+      if (n > size()) std::memset(finish, 0, (n - size()) * sizeof(T));
+      finish = start + n;
+   }
+
+   void clear() { finish = start; }
+
+   // tell the kernel how the elements are going to be read
+   void advise(access_hint hint) const {
+      if (0 == start) return;
+      int advice = MADV_NORMAL;
+      if (hint == sequential) advice = MADV_SEQUENTIAL;
+      if (hint == random) advice = MADV_RANDOM;
+      if (hint == will_need) advice = MADV_WILLNEED;
+      madvise(start, mapped_bytes(), advice);
+   }
+
+   // write dirty pages of a read_write vector back to the file
+   bool flush() const {
+      if (0 == start || map_mode != read_write) return true;
+      return msync(start, size() * sizeof(T), MS_SYNC) == 0;
+   }
+};
+}  // namespace tinystl
+
+#endif
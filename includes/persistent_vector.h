@@ -0,0 +1,419 @@
+#ifndef _PERSISTENT_VECTOR_H_
+#define _PERSISTENT_VECTOR_H_
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+
+namespace tinystl {
+enum { __pvector_bits = 5 };
+enum { __pvector_width = 1 << __pvector_bits };
+enum { __pvector_mask = __pvector_width - 1 };
+
+struct __pvector_node {
+   std::atomic<size_t> refs;
+
+   __pvector_node() : refs(1) {}
+};
+
+struct __pvector_branch : public __pvector_node {
+   __pvector_node* child[__pvector_width];
+
+   __pvector_branch() {
+      for (int i = 0; i < __pvector_width; ++i) child[i] = 0;
+   }
+};
+
+template <class T>
+struct __pvector_leaf : public __pvector_node {
+   size_t size;
+   alignas(T) unsigned char storage[sizeof(T) * __pvector_width];
+
+   __pvector_leaf() : size(0) {}
+   T* values() { return reinterpret_cast<T*>(storage); }
+};
+
+template <class Vector, class T>
+struct __persistent_vector_iterator
+    : public iterator<random_access_iterator_tag, T, std::ptrdiff_t,
+                      const T*, const T&> {
+   typedef __persistent_vector_iterator<Vector, T> self;
+   typedef const T& reference;
+   typedef std::ptrdiff_t difference_type;
+
+   const Vector* v;
+   size_t index;
+   const T* block;  // values of the leaf that holds index
+
+   __persistent_vector_iterator() : v(0), index(0), block(0) {}
+   __persistent_vector_iterator(const Vector* x, size_t i)
+       : v(x), index(i), block(x->leaf_values(i)) {}
+
+   reference operator*() const { return block[index & __pvector_mask]; }
+   const T* operator->() const { return &(operator*()); }
+   reference operator[](difference_type n) const { return (*v)[index + n]; }
+
+   self& operator++() {
+      if ((++index & __pvector_mask) == 0) block = v->leaf_values(index);
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   self& operator--() {
+      if ((index-- & __pvector_mask) == 0) block = v->leaf_values(index);
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --*this;
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      index += n;
+      block = v->leaf_values(index);
+      return *this;
+   }
+   self& operator-=(difference_type n) { return *this += -n; }
+   self operator+(difference_type n) const { return self(v, index + n); }
+   self operator-(difference_type n) const { return self(v, index - n); }
+   difference_type operator-(const self& x) const {
+      return static_cast<difference_type>(index - x.index);
+   }
+
+   bool operator==(const self& x) const { return index == x.index; }
+   bool operator!=(const self& x) const { return index != x.index; }
+   bool operator<(const self& x) const { return index < x.index; }
+   bool operator>(const self& x) const { return x < *this; }
+   bool operator<=(const self& x) const { return !(x < *this); }
+   bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+// An immutable-looking vector whose copies share structure.
+//
+// The elements sit in leaves of 32 under a trie of 32-way branches, as in
+// Clojure's PersistentVector, and the last 1 to 32 elements sit in a tail
+// leaf outside the trie, so push_back and pop_back mostly touch the tail
+// alone. Every node has an atomic reference count. Copying the vector
+// takes a reference on the root and the tail and nothing else, so a
+// snapshot costs the same at any size and can be handed to another thread.
+//
+// Writes copy the path from the root to the element, log32(n) nodes, but
+// only the nodes that are still shared: a node referenced by this vector
+// alone is edited in place. A batch of edits after a snapshot therefore
+// copies each path once and then runs at plain-array speed, which is what
+// a Clojure transient gives, without a separate type to convert to.
+//
+// Copies are independent values and may be used from different threads;
+// one vector object is not safe to write while another thread reads it.
+// Nodes come from Alloc, by default the locked thread_alloc since the last
+// owner of a node may be any thread.
+template <class T, class Alloc = thread_alloc>
+class persistent_vector {
+  public:
+   typedef T value_type;
+   typedef const value_type& const_reference;
+   typedef const value_type& reference;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef __persistent_vector_iterator<persistent_vector, T> iterator;
+   typedef iterator const_iterator;
+
+  protected:
+   typedef __pvector_node node;
+   typedef __pvector_branch branch;
+   typedef __pvector_leaf<T> leaf;
+   typedef simple_alloc<branch, Alloc> branch_allocator;
+   typedef simple_alloc<leaf, Alloc> leaf_allocator;
+
+   size_type count;
+   unsigned shift;  // level of the root, leaves are at level 0
+   branch* root;    // null while everything fits in the tail
+   leaf* tail;      // null when empty
+
+   friend struct __persistent_vector_iterator<persistent_vector, T>;
+
+   static void retain(node* x) {
+      if (x) x->refs.fetch_add(1, std::memory_order_relaxed);
+   }
+   static bool release_ref(node* x) {
+      return x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+   }
+   static void release_leaf(node* x) {
+      if (!x || !release_ref(x)) return;
+      leaf* l = static_cast<leaf*>(x);
+      tinystl::destroy(l->values(), l->values() + l->size);
+      l->~leaf();
+      leaf_allocator::deallocate(l);
+   }
+   static void release_branch(node* x, unsigned level) {
+      if (!x || !release_ref(x)) return;
+      branch* b = static_cast<branch*>(x);
+      for (int i = 0; i < __pvector_width; ++i) {
+         if (level == __pvector_bits) {
+            release_leaf(b->child[i]);
+         } else {
+            release_branch(b->child[i], level - __pvector_bits);
+         }
+      }
+      b->~branch();
+      branch_allocator::deallocate(b);
+   }
+
+   static bool is_unique(node* x) {
+      return x->refs.load(std::memory_order_acquire) == 1;
+   }
+   static branch* new_branch() {
+      branch* b = branch_allocator::allocate();
+      new (b) branch();
+      return b;
+   }
+   static leaf* new_leaf() {
+      leaf* l = leaf_allocator::allocate();
+      new (l) leaf();
+      return l;
+   }
+
+   // the node to write through in place of x: x itself when nothing else
+   // refers to it, else a copy, and the reference to x is given up
+   static branch* writable_branch(node* x, unsigned level) {
+      if (is_unique(x)) return static_cast<branch*>(x);
+      branch* b = new_branch();
+      for (int i = 0; i < __pvector_width; ++i) {
+         b->child[i] = static_cast<branch*>(x)->child[i];
+         retain(b->child[i]);
+      }
+      release_branch(x, level);
+      return b;
+   }
+   static leaf* writable_leaf(node* x) {
+      if (is_unique(x)) return static_cast<leaf*>(x);
+      leaf* src = static_cast<leaf*>(x);
+      leaf* l = new_leaf();
+      try {
+         tinystl::uninitialized_copy(src->values(), src->values() + src->size,
+                                     l->values());
+      } catch (...) {
+         leaf_allocator::deallocate(l);
+         throw;
+      }
+      l->size = src->size;
+      release_leaf(x);
+      return l;
+   }
+
+   // index of the first element in the tail
+   size_type tail_offset() const {
+      return count < size_type(__pvector_width)
+                 ? 0
+                 : ((count - 1) >> __pvector_bits) << __pvector_bits;
+   }
+
+   leaf* leaf_for(size_type i) const {
+      if (i >= tail_offset()) return tail;
+      node* x = root;
+      for (unsigned level = shift; level > 0; level -= __pvector_bits) {
+         x = static_cast<branch*>(x)->child[(i >> level) & __pvector_mask];
+      }
+      return static_cast<leaf*>(x);
+   }
+   const T* leaf_values(size_type i) const {
+      leaf* l = leaf_for(i);
+      return l ? l->values() : 0;
+   }
+
+   // a chain of branches down to level 0 ending in x
+   static node* new_path(unsigned level, node* x) {
+      if (level == 0) return x;
+      branch* b = new_branch();
+      b->child[0] = new_path(level - __pvector_bits, x);
+      return b;
+   }
+
+   // put the full tail x into the trie under parent
+   node* push_tail(unsigned level, node* parent, leaf* x) {
+      branch* b = writable_branch(parent, level);
+      const size_type sub = ((count - 1) >> level) & __pvector_mask;
+      if (level == __pvector_bits) {
+         b->child[sub] = x;
+      } else if (b->child[sub]) {
+         b->child[sub] = push_tail(level - __pvector_bits, b->child[sub], x);
+      } else {
+         b->child[sub] = new_path(level - __pvector_bits, x);
+      }
+      return b;
+   }
+
+   // take the leaf of index count - 2 out of the trie under parent, null
+   // when the subtree becomes empty
+   node* pop_tail(unsigned level, node* parent) {
+      branch* b = writable_branch(parent, level);
+      const size_type sub = ((count - 2) >> level) & __pvector_mask;
+      if (level == __pvector_bits) {
+         release_leaf(b->child[sub]);
+         b->child[sub] = 0;
+      } else {
+         b->child[sub] = pop_tail(level - __pvector_bits, b->child[sub]);
+      }
+      if (sub == 0 && b->child[0] == 0) {
+         release_branch(b, level);
+         return 0;
+      }
+      return b;
+   }
+
+   node* assign(unsigned level, node* x, size_type i, const T& value) {
+      if (level == 0) {
+         leaf* l = writable_leaf(x);
+         l->values()[i & __pvector_mask] = value;
+         return l;
+      }
+      branch* b = writable_branch(x, level);
+      const size_type sub = (i >> level) & __pvector_mask;
+      b->child[sub] = assign(level - __pvector_bits, b->child[sub], i, value);
+      return b;
+   }
+
+   template <class U>
+   void push_back_aux(U&& x) {
+      if (tail && tail->size < size_type(__pvector_width)) {
+         tail = writable_leaf(tail);
+         tinystl::construct(tail->values() + tail->size, std::forward<U>(x));
+         ++tail->size;
+         ++count;
+         return;
+      }
+      leaf* l = new_leaf();
+      try {
+         tinystl::construct(l->values(), std::forward<U>(x));
+      } catch (...) {
+         leaf_allocator::deallocate(l);
+         throw;
+      }
+      l->size = 1;
+      if (tail) {
+         if (!root) {
+            root = new_branch();
+            root->child[0] = tail;
+            shift = __pvector_bits;
+         } else if ((count >> __pvector_bits) > (size_type(1) << shift)) {
+            // the trie is full, grow a level
+            branch* b = new_branch();
+            b->child[0] = root;
+            b->child[1] = new_path(shift, tail);
+            root = b;
+            shift += __pvector_bits;
+         } else {
+            root = static_cast<branch*>(push_tail(shift, root, tail));
+         }
+      }
+      tail = l;
+      ++count;
+   }
+
+  public:
+   persistent_vector() : count(0), shift(__pvector_bits), root(0), tail(0) {}
+   template <class InputIterator>
+   persistent_vector(InputIterator first, InputIterator last)
+       : count(0), shift(__pvector_bits), root(0), tail(0) {
+      for (; first != last; ++first) push_back(*first);
+   }
+   // a snapshot, shares every node with x
+   persistent_vector(const persistent_vector& x)
+       : count(x.count), shift(x.shift), root(x.root), tail(x.tail) {
+      retain(root);
+      retain(tail);
+   }
+   persistent_vector(persistent_vector&& x)
+       : count(x.count), shift(x.shift), root(x.root), tail(x.tail) {
+      x.count = 0;
+      x.shift = __pvector_bits;
+      x.root = 0;
+      x.tail = 0;
+   }
+   persistent_vector& operator=(persistent_vector x) {
+      swap(x);
+      return *this;
+   }
+   ~persistent_vector() {
+      release_branch(root, shift);
+      release_leaf(tail);
+   }
+
+   void swap(persistent_vector& x) {
+      std::swap(count, x.count);
+      std::swap(shift, x.shift);
+      std::swap(root, x.root);
+      std::swap(tail, x.tail);
+   }
+
+   iterator begin() const { return iterator(this, 0); }
+   iterator end() const { return iterator(this, count); }
+
+   size_type size() const { return count; }
+   bool empty() const { return count == 0; }
+
+   const_reference operator[](size_type i) const {
+      return leaf_for(i)->values()[i & __pvector_mask];
+   }
+   const_reference at(size_type i) const {
+      assert(i < count && "persistent_vector index out of range");
+      return (*this)[i];
+   }
+   const_reference front() const { return (*this)[0]; }
+   const_reference back() const { return (*this)[count - 1]; }
+
+   // replace element i, copying the shared nodes on its path
+   void set(size_type i, const T& x) {
+      assert(i < count && "persistent_vector index out of range");
+      if (i >= tail_offset()) {
+         tail = writable_leaf(tail);
+         tail->values()[i & __pvector_mask] = x;
+      } else {
+         root = static_cast<branch*>(assign(shift, root, i, x));
+      }
+   }
+
+   void push_back(const T& x) { push_back_aux(x); }
+   void push_back(T&& x) { push_back_aux(std::move(x)); }
+
+   void pop_back() {
+      assert(count > 0 && "pop_back on an empty persistent_vector");
+      if (tail->size > 1) {
+         tail = writable_leaf(tail);
+         --tail->size;
+         tinystl::destroy(tail->values() + tail->size);
+         --count;
+         return;
+      }
+      release_leaf(tail);
+      tail = 0;
+      if (root) {
+         // the last leaf of the trie becomes the tail
+         tail = leaf_for(count - 2);
+         retain(tail);
+         root = static_cast<branch*>(pop_tail(shift, root));
+         if (root && shift > __pvector_bits && root->child[1] == 0) {
+            branch* b = static_cast<branch*>(root->child[0]);
+            retain(b);
+            release_branch(root, shift);
+            root = b;
+            shift -= __pvector_bits;
+         }
+         if (!root) shift = __pvector_bits;
+      }
+      --count;
+   }
+
+   void clear() { persistent_vector().swap(*this); }
+};
+}  // namespace tinystl
+
+#endif
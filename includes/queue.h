@@ -0,0 +1,163 @@
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "heap.h"
+#include "vector.h"
+
+namespace tinystl {
+// adaptor over a d-ary heap, see heap.h
+template <class T, class Sequence = vector<T>,
+          class Compare = std::less<typename Sequence::value_type>,
+          size_t Arity = __default_heap_arity>
+class priority_queue {
+  public:
+   typedef typename Sequence::value_type value_type;
+   typedef typename Sequence::size_type size_type;
+   typedef typename Sequence::reference reference;
+
+  protected:
+   Sequence c;
+   Compare comp;
+
+  public:
+   priority_queue() : c(), comp() {}
+   explicit priority_queue(const Compare& x) : c(), comp(x) {}
+   // O(n) heap construction over the range constructor of the sequence
+   template <class InputIterator>
+   priority_queue(InputIterator first, InputIterator last,
+                  const Compare& x = Compare())
+       : c(first, last), comp(x) {
+      tinystl::make_heap<Arity>(c.begin(), c.end(), comp);
+   }
+
+   bool empty() const { return c.empty(); }
+   size_type size() const { return c.size(); }
+   const value_type& top() const { return *c.begin(); }
+
+   void push(const value_type& x) {
+      c.push_back(x);
+      tinystl::push_heap<Arity>(c.begin(), c.end(), comp);
+   }
+   void pop() {
+      tinystl::pop_heap<Arity>(c.begin(), c.end(), comp);
+      c.pop_back();
+   }
+};
+
+// A priority queue over the ids 0 .. max_id - 1, each with a key, that can
+// find an id in the heap to change its key or erase it in O(log n).
+//
+// The heap holds (key, id) nodes so comparisons stay within the heap
+// array; pos maps an id to its node. Pops are bottom-up as in heap.h.
+template <class T, class Compare = std::less<T>,
+          size_t Arity = __default_heap_arity>
+class indexed_priority_queue {
+  public:
+   typedef T key_type;
+   typedef size_t size_type;
+   enum { npos = ~size_t(0) };
+
+  protected:
+   struct node {
+      T key;
+      size_type id;
+   };
+
+   vector<node> heap;
+   vector<size_type> pos;  // npos if the id isn't queued
+   Compare comp;
+
+   node& at(size_type i) const { return *(heap.begin() + i); }
+   void place(size_type hole, node& x) {
+      at(hole) = std::move(x);
+      *(pos.begin() + at(hole).id) = hole;
+   }
+
+   void sift_up(size_type hole, size_type top, node x) {
+      while (hole > top) {
+         size_type parent = (hole - 1) / Arity;
+         if (!comp(at(parent).key, x.key)) break;
+         place(hole, at(parent));
+         hole = parent;
+      }
+      place(hole, x);
+   }
+
+   // bottom-up: move the hole to a leaf, then x back up
+   void sift_down(size_type hole, node x) {
+      const size_type top = hole;
+      const size_type len = heap.size();
+      for (;;) {
+         size_type child = Arity * hole + 1;
+         if (child >= len) break;
+         size_type last_child = child + Arity < len ? child + Arity : len;
+         size_type best = child;
+         for (++child; child < last_child; ++child) {
+            if (comp(at(best).key, at(child).key)) best = child;
+         }
+         place(hole, at(best));
+         hole = best;
+      }
+      sift_up(hole, top, std::move(x));
+   }
+
+   // refill the hole at i with x
+   void fix(size_type i, node x) {
+      if (i > 0 && comp(at((i - 1) / Arity).key, x.key))
+         sift_up(i, 0, std::move(x));
+      else
+         sift_down(i, std::move(x));
+   }
+
+  public:
+   explicit indexed_priority_queue(size_type max_id,
+                                   const Compare& x = Compare())
+       : pos(max_id, size_type(npos)), comp(x) {}
+
+   bool empty() const { return heap.empty(); }
+   size_type size() const { return heap.size(); }
+   size_type max_id() const { return pos.size(); }
+   bool contains(size_type id) const {
+      return *(pos.begin() + id) != size_type(npos);
+   }
+
+   size_type top() const { return at(0).id; }
+   const T& top_key() const { return at(0).key; }
+   const T& key(size_type id) const {
+      assert(contains(id) && "id is not in the queue");
+      return at(*(pos.begin() + id)).key;
+   }
+
+   void push(size_type id, const T& k) {
+      assert(id < max_id() && !contains(id) && "bad id");
+      node x = {k, id};
+      heap.push_back(x);
+      sift_up(heap.size() - 1, 0, std::move(x));
+   }
+
+   // set a new key for a queued id, it may move either way
+   void update(size_type id, const T& k) {
+      assert(contains(id) && "id is not in the queue");
+      size_type i = *(pos.begin() + id);
+      node x = {k, id};
+      fix(i, std::move(x));
+   }
+
+   void pop() { erase(top()); }
+
+   void erase(size_type id) {
+      assert(contains(id) && "id is not in the queue");
+      size_type i = *(pos.begin() + id);
+      *(pos.begin() + id) = size_type(npos);
+      node last = std::move(heap.back());
+      heap.pop_back();
+      if (i < heap.size()) fix(i, std::move(last));
+   }
+};
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,706 @@
+#ifndef _RANGES_H_
+#define _RANGES_H_
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "vector.h"
+
+// Lazy views over tinystl containers.
+//
+// r | views::filter(p) | views::transform(f) | views::take(n) builds a view,
+// a small object holding the view below it and the function. Nothing is
+// evaluated or allocated until it is iterated, and then every element goes
+// through the whole pipeline in one pass; collect and to_vector materialize
+// the result.
+//
+// A view refers to an lvalue container or named generator, which must outlive
+// it, and owns an rvalue range such as a temporary generator. Iterators point
+// into their view, so a view must not move while it is iterated. Iterator
+// categories follow the base: transform and drop keep it, filter caps it at
+// bidirectional, chunk at forward, and take and zip keep random access but
+// otherwise stop at forward, as they can't find their end from the back.
+
+namespace tinystl {
+// every view derives from this, views are moved into the views built on them
+struct __view_base {};
+
+template <class Range>
+struct __range_iterator {
+   typedef decltype(std::declval<Range&>().begin()) type;
+};
+
+// the weaker of two iterator categories
+template <class Category1, class Category2>
+struct __min_category {
+   typedef typename std::conditional<
+       std::is_base_of<Category2, Category1>::value, Category2,
+       Category1>::type type;
+};
+
+// random access, or at most forward
+template <class Category>
+struct __counted_category {
+   typedef typename std::conditional<
+       std::is_base_of<random_access_iterator_tag, Category>::value,
+       Category,
+       typename __min_category<Category, forward_iterator_tag>::type>::type
+       type;
+};
+
+// first advanced by n but no further than last
+template <class Iterator, class Distance>
+inline Iterator __bounded_next(Iterator first, Iterator last, Distance n,
+                               input_iterator_tag) {
+   for (; n > 0 && first != last; --n) ++first;
+   return first;
+}
+
+template <class Iterator, class Distance>
+inline Iterator __bounded_next(Iterator first, Iterator last, Distance n,
+                               random_access_iterator_tag) {
+   return last - first < n ? last : first + n;
+}
+
+template <class Range>
+class __ref_view : public __view_base {
+  protected:
+   Range* r;
+
+  public:
+   typedef typename __range_iterator<Range>::type iterator;
+   explicit __ref_view(Range& x) : r(&x) {}
+   iterator begin() { return r->begin(); }
+   iterator end() { return r->end(); }
+};
+
+template <class Range>
+class __owning_view : public __view_base {
+  protected:
+   Range r;
+
+  public:
+   typedef typename __range_iterator<Range>::type iterator;
+   explicit __owning_view(Range&& x) : r(std::move(x)) {}
+   iterator begin() { return r.begin(); }
+   iterator end() { return r.end(); }
+};
+
+// the view a pipeline stores for Range, deduced as a forwarding reference:
+// views are stored by value unless they are lvalues that can't be copied,
+// such as a named generator, other lvalues are referred to
+template <class Range>
+struct __all {
+   typedef typename std::decay<Range>::type R;
+   typedef __ref_view<typename std::remove_reference<Range>::type> ref_view;
+   typedef typename std::conditional<
+       std::is_base_of<__view_base, R>::value,
+       typename std::conditional<std::is_lvalue_reference<Range>::value &&
+                                     !std::is_copy_constructible<R>::value,
+                                 ref_view, R>::type,
+       typename std::conditional<std::is_lvalue_reference<Range>::value,
+                                 ref_view, __owning_view<R>>::type>::type
+       type;
+};
+
+template <class Range>
+inline typename __all<Range>::type __view_all(Range&& r) {
+   return typename __all<Range>::type(std::forward<Range>(r));
+}
+
+// ---------------------------------------------------------------------------
+// filter
+
+template <class Iterator, class Pred>
+struct __filter_iterator
+    : public iterator<
+          typename __min_category<
+              typename iterator_traits<Iterator>::iterator_category,
+              bidirectional_iterator_tag>::type,
+          typename iterator_traits<Iterator>::value_type,
+          typename iterator_traits<Iterator>::difference_type,
+          typename iterator_traits<Iterator>::pointer,
+          typename iterator_traits<Iterator>::reference> {
+   typedef __filter_iterator<Iterator, Pred> self;
+   typedef typename iterator_traits<Iterator>::reference reference;
+
+   Iterator cur, last;
+   const Pred* pred;
+
+   __filter_iterator() : pred(0) {}
+   __filter_iterator(Iterator c, Iterator l, const Pred* p)
+       : cur(c), last(l), pred(p) {
+      satisfy();
+   }
+
+   void satisfy() {
+      while (cur != last && !(*pred)(*cur)) ++cur;
+   }
+
+   reference operator*() const { return *cur; }
+   self& operator++() {
+      ++cur;
+      satisfy();
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   self& operator--() {
+      do {
+         --cur;
+      } while (!(*pred)(*cur));
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --*this;
+      return tmp;
+   }
+   bool operator==(const self& x) const { return cur == x.cur; }
+   bool operator!=(const self& x) const { return !(cur == x.cur); }
+};
+
+template <class View, class Pred>
+class filter_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View>::type base_iterator;
+   View base;
+   Pred pred;
+
+  public:
+   typedef __filter_iterator<base_iterator, Pred> iterator;
+   filter_view(View v, Pred p) : base(std::move(v)), pred(std::move(p)) {}
+   // finds the first match on every call
+   iterator begin() { return iterator(base.begin(), base.end(), &pred); }
+   iterator end() {
+      base_iterator last = base.end();
+      return iterator(last, last, &pred);
+   }
+};
+
+// ---------------------------------------------------------------------------
+// transform
+
+template <class Iterator, class F>
+struct __transform_reference {
+   typedef decltype(std::declval<const F&>()(
+       *std::declval<Iterator&>())) type;
+};
+
+template <class Iterator, class F>
+struct __transform_iterator
+    : public iterator<
+          typename iterator_traits<Iterator>::iterator_category,
+          typename std::decay<
+              typename __transform_reference<Iterator, F>::type>::type,
+          typename iterator_traits<Iterator>::difference_type, void,
+          typename __transform_reference<Iterator, F>::type> {
+   typedef __transform_iterator<Iterator, F> self;
+   typedef typename __transform_reference<Iterator, F>::type reference;
+   typedef typename iterator_traits<Iterator>::difference_type
+       difference_type;
+
+   Iterator cur;
+   const F* f;
+
+   __transform_iterator() : f(0) {}
+   __transform_iterator(Iterator c, const F* x) : cur(c), f(x) {}
+
+   reference operator*() const { return (*f)(*cur); }
+   reference operator[](difference_type n) const { return (*f)(cur[n]); }
+
+   self& operator++() {
+      ++cur;
+      return *this;
+   }
+   self operator++(int) { return self(cur++, f); }
+   self& operator--() {
+      --cur;
+      return *this;
+   }
+   self operator--(int) { return self(cur--, f); }
+   self& operator+=(difference_type n) {
+      cur += n;
+      return *this;
+   }
+   self& operator-=(difference_type n) {
+      cur -= n;
+      return *this;
+   }
+   self operator+(difference_type n) const { return self(cur + n, f); }
+   self operator-(difference_type n) const { return self(cur - n, f); }
+   difference_type operator-(const self& x) const { return cur - x.cur; }
+
+   bool operator==(const self& x) const { return cur == x.cur; }
+   bool operator!=(const self& x) const { return !(cur == x.cur); }
+   bool operator<(const self& x) const { return cur < x.cur; }
+   bool operator>(const self& x) const { return x.cur < cur; }
+   bool operator<=(const self& x) const { return !(x.cur < cur); }
+   bool operator>=(const self& x) const { return !(cur < x.cur); }
+};
+
+template <class View, class F>
+class transform_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View>::type base_iterator;
+   View base;
+   F f;
+
+  public:
+   typedef __transform_iterator<base_iterator, F> iterator;
+   transform_view(View v, F x) : base(std::move(v)), f(std::move(x)) {}
+   iterator begin() { return iterator(base.begin(), &f); }
+   iterator end() { return iterator(base.end(), &f); }
+};
+
+// ---------------------------------------------------------------------------
+// take
+
+// counts the elements left, the end has none left or is the end of the base
+template <class Iterator>
+struct __take_iterator
+    : public iterator<
+          typename __counted_category<
+              typename iterator_traits<Iterator>::iterator_category>::type,
+          typename iterator_traits<Iterator>::value_type,
+          typename iterator_traits<Iterator>::difference_type,
+          typename iterator_traits<Iterator>::pointer,
+          typename iterator_traits<Iterator>::reference> {
+   typedef __take_iterator<Iterator> self;
+   typedef typename iterator_traits<Iterator>::reference reference;
+   typedef typename iterator_traits<Iterator>::difference_type
+       difference_type;
+
+   Iterator cur;
+   difference_type n;
+
+   __take_iterator() : n(0) {}
+   __take_iterator(Iterator c, difference_type x) : cur(c), n(x) {}
+
+   reference operator*() const { return *cur; }
+   reference operator[](difference_type k) const { return cur[k]; }
+
+   self& operator++() {
+      ++cur;
+      --n;
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   self& operator--() {
+      --cur;
+      ++n;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --*this;
+      return tmp;
+   }
+   self& operator+=(difference_type k) {
+      cur += k;
+      n -= k;
+      return *this;
+   }
+   self& operator-=(difference_type k) { return *this += -k; }
+   self operator+(difference_type k) const { return self(cur + k, n - k); }
+   self operator-(difference_type k) const { return self(cur - k, n + k); }
+   difference_type operator-(const self& x) const { return x.n - n; }
+
+   bool operator==(const self& x) const { return n == x.n || cur == x.cur; }
+   bool operator!=(const self& x) const { return !(*this == x); }
+   bool operator<(const self& x) const { return x.n < n; }
+   bool operator>(const self& x) const { return n < x.n; }
+   bool operator<=(const self& x) const { return !(n < x.n); }
+   bool operator>=(const self& x) const { return !(x.n < n); }
+};
+
+template <class View>
+class take_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View>::type base_iterator;
+   typedef typename iterator_traits<base_iterator>::iterator_category
+       base_category;
+   typedef typename iterator_traits<base_iterator>::difference_type
+       difference_type;
+   View base;
+   difference_type count;
+
+   // a random access end is exact, so that end() - begin() is the size
+   __take_iterator<base_iterator> make_end(input_iterator_tag) {
+      return __take_iterator<base_iterator>(base.end(), 0);
+   }
+   __take_iterator<base_iterator> make_end(random_access_iterator_tag) {
+      base_iterator first = base.begin();
+      return __take_iterator<base_iterator>(
+          __bounded_next(first, base.end(), count, base_category()), 0);
+   }
+   difference_type begin_count(base_iterator, input_iterator_tag) {
+      return count;
+   }
+   difference_type begin_count(base_iterator first,
+                               random_access_iterator_tag) {
+      return make_end(base_category()).cur - first;
+   }
+
+  public:
+   typedef __take_iterator<base_iterator> iterator;
+   take_view(View v, difference_type n) : base(std::move(v)), count(n) {}
+   iterator begin() {
+      base_iterator first = base.begin();
+      return iterator(first, begin_count(first, base_category()));
+   }
+   iterator end() { return make_end(base_category()); }
+};
+
+// ---------------------------------------------------------------------------
+// drop
+
+template <class View>
+class drop_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View>::type base_iterator;
+   typedef typename iterator_traits<base_iterator>::difference_type
+       difference_type;
+   View base;
+   difference_type count;
+
+  public:
+   typedef base_iterator iterator;
+   drop_view(View v, difference_type n) : base(std::move(v)), count(n) {}
+   iterator begin() {
+      base_iterator first = base.begin();
+      return __bounded_next(first, base.end(), count,
+                            iterator_category(first));
+   }
+   iterator end() { return base.end(); }
+};
+
+// ---------------------------------------------------------------------------
+// zip
+
+// stops at the end of the shorter range
+template <class Iterator1, class Iterator2>
+struct __zip_iterator
+    : public iterator<
+          typename __counted_category<typename __min_category<
+              typename iterator_traits<Iterator1>::iterator_category,
+              typename iterator_traits<Iterator2>::iterator_category>::
+                                          type>::type,
+          std::pair<typename iterator_traits<Iterator1>::value_type,
+                    typename iterator_traits<Iterator2>::value_type>,
+          std::ptrdiff_t, void,
+          std::pair<typename iterator_traits<Iterator1>::reference,
+                    typename iterator_traits<Iterator2>::reference>> {
+   typedef __zip_iterator<Iterator1, Iterator2> self;
+   typedef std::pair<typename iterator_traits<Iterator1>::reference,
+                     typename iterator_traits<Iterator2>::reference>
+       reference;
+   typedef std::ptrdiff_t difference_type;
+
+   Iterator1 first;
+   Iterator2 second;
+
+   __zip_iterator() {}
+   __zip_iterator(Iterator1 x, Iterator2 y) : first(x), second(y) {}
+
+   reference operator*() const { return reference(*first, *second); }
+   reference operator[](difference_type n) const {
+      return reference(first[n], second[n]);
+   }
+
+   self& operator++() {
+      ++first;
+      ++second;
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   self& operator--() {
+      --first;
+      --second;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --*this;
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      first += n;
+      second += n;
+      return *this;
+   }
+   self& operator-=(difference_type n) { return *this += -n; }
+   self operator+(difference_type n) const {
+      return self(first + n, second + n);
+   }
+   self operator-(difference_type n) const {
+      return self(first - n, second - n);
+   }
+   difference_type operator-(const self& x) const { return first - x.first; }
+
+   bool operator==(const self& x) const {
+      return first == x.first || second == x.second;
+   }
+   bool operator!=(const self& x) const { return !(*this == x); }
+   bool operator<(const self& x) const { return first < x.first; }
+   bool operator>(const self& x) const { return x.first < first; }
+   bool operator<=(const self& x) const { return !(x.first < first); }
+   bool operator>=(const self& x) const { return !(first < x.first); }
+};
+
+template <class View1, class View2>
+class zip_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View1>::type base_iterator1;
+   typedef typename __range_iterator<View2>::type base_iterator2;
+   View1 base1;
+   View2 base2;
+
+  public:
+   typedef __zip_iterator<base_iterator1, base_iterator2> iterator;
+
+  protected:
+   typedef typename iterator::iterator_category category;
+   iterator make_end(input_iterator_tag) {
+      return iterator(base1.end(), base2.end());
+   }
+   iterator make_end(random_access_iterator_tag) {
+      base_iterator1 first1 = base1.begin();
+      base_iterator2 first2 = base2.begin();
+      std::ptrdiff_t n = base1.end() - first1;
+      if (base2.end() - first2 < n) n = base2.end() - first2;
+      return iterator(first1 + n, first2 + n);
+   }
+
+  public:
+   zip_view(View1 x, View2 y) : base1(std::move(x)), base2(std::move(y)) {}
+   iterator begin() { return iterator(base1.begin(), base2.begin()); }
+   iterator end() { return make_end(category()); }
+};
+
+// ---------------------------------------------------------------------------
+// chunk
+
+template <class Iterator>
+class subrange : public __view_base {
+  protected:
+   Iterator first, last;
+
+  public:
+   typedef Iterator iterator;
+   subrange(Iterator x, Iterator y) : first(x), last(y) {}
+   iterator begin() const { return first; }
+   iterator end() const { return last; }
+   bool empty() const { return first == last; }
+};
+
+template <class Iterator>
+struct __chunk_iterator
+    : public iterator<
+          typename __min_category<
+              typename iterator_traits<Iterator>::iterator_category,
+              forward_iterator_tag>::type,
+          subrange<Iterator>,
+          typename iterator_traits<Iterator>::difference_type, void,
+          subrange<Iterator>> {
+   typedef __chunk_iterator<Iterator> self;
+   typedef typename iterator_traits<Iterator>::difference_type
+       difference_type;
+
+   Iterator cur, next, last;
+   difference_type n;
+
+   __chunk_iterator() : n(0) {}
+   __chunk_iterator(Iterator c, Iterator l, difference_type x)
+       : cur(c), next(step(c, l, x)), last(l), n(x) {}
+
+   static Iterator step(Iterator c, Iterator l, difference_type x) {
+      return __bounded_next(c, l, x, iterator_category(c));
+   }
+
+   subrange<Iterator> operator*() const {
+      return subrange<Iterator>(cur, next);
+   }
+   self& operator++() {
+      cur = next;
+      next = step(cur, last, n);
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   bool operator==(const self& x) const { return cur == x.cur; }
+   bool operator!=(const self& x) const { return !(cur == x.cur); }
+};
+
+// consecutive subranges of n elements, the last may be shorter
+template <class View>
+class chunk_view : public __view_base {
+  protected:
+   typedef typename __range_iterator<View>::type base_iterator;
+   static_assert(
+       std::is_base_of<forward_iterator_tag,
+                       typename iterator_traits<
+                           base_iterator>::iterator_category>::value,
+       "chunk needs a forward range");
+   typedef typename iterator_traits<base_iterator>::difference_type
+       difference_type;
+   View base;
+   difference_type count;
+
+  public:
+   typedef __chunk_iterator<base_iterator> iterator;
+   chunk_view(View v, difference_type n) : base(std::move(v)), count(n) {}
+   iterator begin() { return iterator(base.begin(), base.end(), count); }
+   iterator end() {
+      base_iterator last = base.end();
+      return iterator(last, last, count);
+   }
+};
+
+// ---------------------------------------------------------------------------
+// adaptors, r | views::filter(p) is views::filter(p)(r)
+
+struct __adaptor_base {};
+
+template <class Range, class Adaptor>
+inline typename std::enable_if<
+    std::is_base_of<__adaptor_base, Adaptor>::value,
+    decltype(std::declval<const Adaptor&>()(std::declval<Range>()))>::type
+operator|(Range&& r, const Adaptor& a) {
+   return a(std::forward<Range>(r));
+}
+
+template <class Pred>
+struct __filter_adaptor : public __adaptor_base {
+   Pred pred;
+   explicit __filter_adaptor(Pred p) : pred(std::move(p)) {}
+   template <class Range>
+   filter_view<typename __all<Range>::type, Pred> operator()(
+       Range&& r) const {
+      return filter_view<typename __all<Range>::type, Pred>(
+          __view_all(std::forward<Range>(r)), pred);
+   }
+};
+
+template <class F>
+struct __transform_adaptor : public __adaptor_base {
+   F f;
+   explicit __transform_adaptor(F x) : f(std::move(x)) {}
+   template <class Range>
+   transform_view<typename __all<Range>::type, F> operator()(
+       Range&& r) const {
+      return transform_view<typename __all<Range>::type, F>(
+          __view_all(std::forward<Range>(r)), f);
+   }
+};
+
+// take, drop and chunk: a view over the range and a count
+template <template <class> class View>
+struct __count_adaptor : public __adaptor_base {
+   std::ptrdiff_t n;
+   explicit __count_adaptor(std::ptrdiff_t x) : n(x) {}
+   template <class Range>
+   View<typename __all<Range>::type> operator()(Range&& r) const {
+      return View<typename __all<Range>::type>(
+          __view_all(std::forward<Range>(r)), n);
+   }
+};
+
+template <class Container, class Range>
+Container collect(Range&& r) {
+   Container result;
+   for (auto first = r.begin(), last = r.end(); first != last; ++first)
+      result.push_back(*first);
+   return result;
+}
+
+template <class Range>
+struct __range_value {
+   typedef typename iterator_traits<
+       typename __range_iterator<Range>::type>::value_type type;
+};
+
+template <class T, class Iterator>
+inline void __reserve_for(vector<T>& v, Iterator first, Iterator last,
+                          random_access_iterator_tag) {
+   v.reserve(last - first);
+}
+
+template <class T, class Iterator>
+inline void __reserve_for(vector<T>&, Iterator, Iterator,
+                          input_iterator_tag) {}
+
+// one pass; sized up front when the range is random access
+template <class Range>
+vector<typename __range_value<Range>::type> to_vector(Range&& r) {
+   vector<typename __range_value<Range>::type> result;
+   auto first = r.begin();
+   auto last = r.end();
+   __reserve_for(result, first, last, iterator_category(first));
+   for (; first != last; ++first) result.push_back(*first);
+   return result;
+}
+
+struct __to_vector_adaptor : public __adaptor_base {
+   template <class Range>
+   vector<typename __range_value<Range>::type> operator()(Range&& r) const {
+      return tinystl::to_vector(std::forward<Range>(r));
+   }
+};
+
+namespace views {
+template <class Range>
+inline typename __all<Range>::type all(Range&& r) {
+   return __view_all(std::forward<Range>(r));
+}
+
+template <class Pred>
+inline __filter_adaptor<Pred> filter(Pred pred) {
+   return __filter_adaptor<Pred>(std::move(pred));
+}
+
+template <class F>
+inline __transform_adaptor<F> transform(F f) {
+   return __transform_adaptor<F>(std::move(f));
+}
+
+inline __count_adaptor<take_view> take(std::ptrdiff_t n) {
+   return __count_adaptor<take_view>(n);
+}
+
+inline __count_adaptor<drop_view> drop(std::ptrdiff_t n) {
+   return __count_adaptor<drop_view>(n);
+}
+
+inline __count_adaptor<chunk_view> chunk(std::ptrdiff_t n) {
+   return __count_adaptor<chunk_view>(n);
+}
+
+template <class Range1, class Range2>
+inline zip_view<typename __all<Range1>::type, typename __all<Range2>::type>
+zip(Range1&& r1, Range2&& r2) {
+   return zip_view<typename __all<Range1>::type, typename __all<Range2>::type>(
+       __view_all(std::forward<Range1>(r1)),
+       __view_all(std::forward<Range2>(r2)));
+}
+
+inline __to_vector_adaptor to_vector() { return __to_vector_adaptor(); }
+}  // namespace views
+}  // namespace tinystl
+
+#endif
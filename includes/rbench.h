@@ -0,0 +1,236 @@
+#ifndef _RBENCH_H_
+#define _RBENCH_H_
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace rtest {
+// keep the compiler from discarding a value that is otherwise unused
+template <class T>
+inline void DoNotOptimize(const T& value) {
+   asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// force pending writes to memory and forget everything cached in registers
+inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+
+// passed to every benchmark body, only the loop is timed:
+//    while (state.keep_running()) { ... }
+class State {
+  private:
+   typedef std::chrono::steady_clock clock;
+   size_t iterations_;
+   size_t remaining_;
+   long long arg_;
+   clock::time_point start_;
+   clock::time_point stop_;
+
+  public:
+   State(size_t iterations, long long arg)
+       : iterations_(iterations), remaining_(iterations), arg_(arg) {}
+
+   bool keep_running() {
+      if (remaining_ == iterations_) start_ = clock::now();
+      if (remaining_ == 0) {
+         stop_ = clock::now();
+         return false;
+      }
+      --remaining_;
+      return true;
+   }
+   long long range() const { return arg_; }
+   size_t iterations() const { return iterations_; }
+   double elapsed_ns() const {
+      return std::chrono::duration<double, std::nano>(stop_ - start_).count();
+   }
+};
+
+struct BenchmarkResult {
+   std::string name;
+   std::string impl;
+   long long arg;
+   size_t iterations;
+   // nanoseconds per iteration
+   double median;
+   double p99;
+   double mean;
+   double stddev;
+};
+
+class Benchmarker {
+  private:
+   struct Benchmark {
+      std::string name;
+      std::function<void(State&)> body;
+      // the std:: counterpart, may be empty
+      std::function<void(State&)> baseline;
+      std::vector<long long> args;
+   };
+   static std::vector<Benchmark> benchmarks;
+   static std::vector<BenchmarkResult> results;
+   static int warmup_samples;
+   static int samples;
+   static double min_sample_ns;
+
+   // grow the iteration count until one sample runs for min_sample_ns
+   static size_t scale_iterations(const std::function<void(State&)>& body,
+                                  long long arg) {
+      size_t iterations = 1;
+      for (;;) {
+         State state(iterations, arg);
+         body(state);
+         double elapsed = state.elapsed_ns();
+         if (elapsed >= min_sample_ns || iterations >= (size_t(1) << 30))
+            return iterations;
+         double factor = elapsed > 0 ? 1.4 * min_sample_ns / elapsed : 10;
+         factor = std::min(std::max(factor, 2.0), 10.0);
+         iterations = static_cast<size_t>(iterations * factor);
+      }
+   }
+
+   static BenchmarkResult measure(const std::string& name,
+                                  const std::string& impl,
+                                  const std::function<void(State&)>& body,
+                                  long long arg) {
+      size_t iterations = scale_iterations(body, arg);
+      for (int i = 0; i < warmup_samples; ++i) {
+         State state(iterations, arg);
+         body(state);
+      }
+      std::vector<double> ns;
+      for (int i = 0; i < samples; ++i) {
+         State state(iterations, arg);
+         body(state);
+         ns.push_back(state.elapsed_ns() / iterations);
+      }
+      std::sort(ns.begin(), ns.end());
+
+      BenchmarkResult r;
+      r.name = name;
+      r.impl = impl;
+      r.arg = arg;
+      r.iterations = iterations;
+      size_t n = ns.size();
+      r.median = n % 2 ? ns[n / 2] : (ns[n / 2 - 1] + ns[n / 2]) / 2;
+      r.p99 = ns[static_cast<size_t>(std::ceil(0.99 * n)) - 1];
+      r.mean = 0;
+      for (double x : ns) r.mean += x;
+      r.mean /= n;
+      r.stddev = 0;
+      for (double x : ns) r.stddev += (x - r.mean) * (x - r.mean);
+      r.stddev = n > 1 ? std::sqrt(r.stddev / (n - 1)) : 0;
+      return r;
+   }
+
+   static const BenchmarkResult* find_baseline(const BenchmarkResult& r) {
+      for (const BenchmarkResult& b : results) {
+         if (b.impl == "std" && b.name == r.name && b.arg == r.arg) return &b;
+      }
+      return 0;
+   }
+
+   static void print(const BenchmarkResult& r) {
+      char line[256];
+      std::string name = r.name + '/' + std::to_string(r.arg);
+      std::snprintf(line, sizeof(line),
+                    "%-36s %-8s %12zu %12.1f %12.1f %10.1f", name.c_str(),
+                    r.impl.c_str(), r.iterations, r.median, r.p99, r.stddev);
+      std::cout << line;
+      const BenchmarkResult* base = find_baseline(r);
+      if (base && base != &r && base->median > 0) {
+         std::snprintf(line, sizeof(line), " %8.2fx", r.median / base->median);
+         std::cout << line;
+      }
+      std::cout << '\n';
+   }
+
+   static void write_json(const std::string& path) {
+      std::ofstream out(path);
+      out << "{\n  \"benchmarks\": [";
+      for (size_t i = 0; i < results.size(); ++i) {
+         const BenchmarkResult& r = results[i];
+         out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+             << "\", \"impl\": \"" << r.impl << "\", \"arg\": " << r.arg
+             << ", \"iterations\": " << r.iterations
+             << ", \"median_ns\": " << r.median << ", \"p99_ns\": " << r.p99
+             << ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": " << r.stddev
+             << "}";
+      }
+      out << "\n  ]\n}\n";
+   }
+
+  public:
+   static void add_benchmark(std::string name,
+                             std::function<void(State&)> body,
+                             std::vector<long long> args = {0}) {
+      benchmarks.push_back(
+          Benchmark{name, body, std::function<void(State&)>(), args});
+   }
+
+   // run a tinystl benchmark side by side with its std:: counterpart
+   static void add_comparison(std::string name,
+                              std::function<void(State&)> tinystl_body,
+                              std::function<void(State&)> std_body,
+                              std::vector<long long> args = {0}) {
+      benchmarks.push_back(Benchmark{name, tinystl_body, std_body, args});
+   }
+
+   // lo, lo * multiplier, ... up to and including hi
+   static std::vector<long long> range(long long lo, long long hi,
+                                       long long multiplier = 8) {
+      assert(lo > 0 && multiplier > 1 && "range would never reach hi");
+      std::vector<long long> args;
+      for (long long x = lo; x < hi; x *= multiplier) args.push_back(x);
+      args.push_back(hi);
+      return args;
+   }
+
+   static void set_samples(int n) { samples = n; }
+   static void set_min_time(double ms) { min_sample_ns = ms * 1e6; }
+
+   // optional arguments: --json=<path> --samples=<n> --min_time_ms=<ms>
+   static void run(int argc = 0, char** argv = 0) {
+      std::string json_path;
+      for (int i = 1; i < argc; ++i) {
+         std::string a = argv[i];
+         if (a.compare(0, 7, "--json=") == 0) json_path = a.substr(7);
+         if (a.compare(0, 10, "--samples=") == 0)
+            set_samples(std::stoi(a.substr(10)));
+         if (a.compare(0, 14, "--min_time_ms=") == 0)
+            set_min_time(std::stod(a.substr(14)));
+      }
+      char line[256];
+      std::snprintf(line, sizeof(line), "%-36s %-8s %12s %12s %12s %10s %9s",
+                    "Benchmark", "Impl", "Iterations", "Median(ns)",
+                    "P99(ns)", "Stddev", "vs std");
+      std::cout << line << '\n';
+      for (const Benchmark& bm : benchmarks) {
+         for (long long arg : bm.args) {
+            if (bm.baseline) {
+               results.push_back(measure(bm.name, "std", bm.baseline, arg));
+               print(results.back());
+            }
+            results.push_back(measure(bm.name, "tinystl", bm.body, arg));
+            print(results.back());
+         }
+      }
+      if (!json_path.empty()) write_json(json_path);
+   }
+
+   static const std::vector<BenchmarkResult>& get_results() { return results; }
+};
+std::vector<Benchmarker::Benchmark> Benchmarker::benchmarks;
+std::vector<BenchmarkResult> Benchmarker::results;
+int Benchmarker::warmup_samples = 2;
+int Benchmarker::samples = 15;
+double Benchmarker::min_sample_ns = 5e6;
+
+};  // namespace rtest
+#endif
@@ -0,0 +1,201 @@
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+
+namespace tinystl {
+template <class T>
+struct __ring_iterator
+    : public iterator<random_access_iterator_tag, T, std::ptrdiff_t> {
+   typedef __ring_iterator<T> self;
+   typedef T& reference;
+   typedef std::ptrdiff_t difference_type;
+
+   T* buf;
+   size_t mask;
+   size_t index;  // position in the free-running sequence, not in buf
+
+   __ring_iterator() : buf(0), mask(0), index(0) {}
+   __ring_iterator(T* b, size_t m, size_t i) : buf(b), mask(m), index(i) {}
+
+   reference operator*() const { return buf[index & mask]; }
+   T* operator->() const { return &(operator*()); }
+   reference operator[](difference_type n) const {
+      return buf[(index + n) & mask];
+   }
+
+   self& operator++() {
+      ++index;
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++index;
+      return tmp;
+   }
+   self& operator--() {
+      --index;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --index;
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      index += n;
+      return *this;
+   }
+   self& operator-=(difference_type n) {
+      index -= n;
+      return *this;
+   }
+   self operator+(difference_type n) const {
+      return self(buf, mask, index + n);
+   }
+   self operator-(difference_type n) const {
+      return self(buf, mask, index - n);
+   }
+   difference_type operator-(const self& x) const {
+      return static_cast<difference_type>(index - x.index);
+   }
+
+   bool operator==(const self& x) const { return index == x.index; }
+   bool operator!=(const self& x) const { return index != x.index; }
+   bool operator<(const self& x) const { return *this - x < 0; }
+   bool operator>(const self& x) const { return x < *this; }
+   bool operator<=(const self& x) const { return !(x < *this); }
+   bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+// A fixed capacity double-ended queue on a circular array.
+//
+// The capacity is rounded up to a power of two, so positions wrap with a
+// mask; head and tail run freely and size() is tail - head. The live
+// elements occupy at most two contiguous runs, array_one() and array_two(),
+// which can be handed to writev or copied with one memmove each.
+// Pushing into a full buffer is an error.
+template <class T, class Alloc = alloc>
+class ring_buffer {
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef __ring_iterator<T> iterator;
+   typedef value_type& reference;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+
+  protected:
+   typedef simple_alloc<value_type, Alloc> data_allocator;
+
+   pointer buf;
+   size_type mask;
+   size_type head, tail;
+
+   static size_type round_up(size_type n) {
+      size_type cap = 1;
+      while (cap < n) cap <<= 1;
+      return cap;
+   }
+
+   // destroy the n elements starting at position first
+   void destroy_n(size_type first, size_type n) {
+      const size_type i = first & mask;
+      const size_type run = tinystl::min(n, capacity() - i);
+      tinystl::destroy(buf + i, buf + i + run);
+      tinystl::destroy(buf, buf + (n - run));
+   }
+
+  public:
+   explicit ring_buffer(size_type n) : head(0), tail(0) {
+      const size_type cap = round_up(n);
+      buf = data_allocator::allocate(cap);
+      mask = cap - 1;
+   }
+   ~ring_buffer() {
+      clear();
+      data_allocator::deallocate(buf, capacity());
+   }
+
+   ring_buffer(const ring_buffer&) = delete;
+   ring_buffer& operator=(const ring_buffer&) = delete;
+
+   iterator begin() const { return iterator(buf, mask, head); }
+   iterator end() const { return iterator(buf, mask, tail); }
+   size_type size() const { return tail - head; }
+   size_type capacity() const { return mask + 1; }
+   bool empty() const { return head == tail; }
+   bool full() const { return size() == capacity(); }
+   reference operator[](size_type n) const { return buf[(head + n) & mask]; }
+   reference front() const { return buf[head & mask]; }
+   reference back() const { return buf[(tail - 1) & mask]; }
+
+   void push_back(const T& x) {
+      assert(!full() && "ring_buffer is full");
+      tinystl::construct(buf + (tail & mask), x);
+      ++tail;
+   }
+   void push_front(const T& x) {
+      assert(!full() && "ring_buffer is full");
+      tinystl::construct(buf + ((head - 1) & mask), x);
+      --head;
+   }
+   void pop_back() {
+      --tail;
+      tinystl::destroy(buf + (tail & mask));
+   }
+   void pop_front() {
+      tinystl::destroy(buf + (head & mask));
+      ++head;
+   }
+
+   // append n elements, one uninitialized_copy per contiguous run
+   void push_n(const T* first, size_type n) {
+      assert(n <= capacity() - size() && "ring_buffer is full");
+      const size_type i = tail & mask;
+      const size_type run = tinystl::min(n, capacity() - i);
+      tinystl::uninitialized_copy(first, first + run, buf + i);
+      tinystl::uninitialized_copy(first + run, first + n, buf);
+      tail += n;
+   }
+
+   // copy the n front elements to result and drop them
+   template <class OutputIterator>
+   OutputIterator pop_n(OutputIterator result, size_type n) {
+      assert(n <= size() && "not enough elements in ring_buffer");
+      const size_type i = head & mask;
+      const size_type run = tinystl::min(n, capacity() - i);
+      result = tinystl::copy(buf + i, buf + i + run, result);
+      result = tinystl::copy(buf, buf + (n - run), result);
+      pop_n(n);
+      return result;
+   }
+
+   // drop the n front elements
+   void pop_n(size_type n) {
+      assert(n <= size() && "not enough elements in ring_buffer");
+      destroy_n(head, n);
+      head += n;
+   }
+
+   void clear() { pop_n(size()); }
+
+   // the live elements are array_one() followed by array_two()
+   std::pair<pointer, size_type> array_one() const {
+      const size_type i = head & mask;
+      return std::make_pair(buf + i, tinystl::min(size(), capacity() - i));
+   }
+   std::pair<pointer, size_type> array_two() const {
+      return std::make_pair(buf, size() - array_one().second);
+   }
+};
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef _SEGMENTED_VECTOR_H_
+#define _SEGMENTED_VECTOR_H_
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace tinystl {
+// elements per block: a power of two filling about 512 bytes, at least 8
+inline constexpr size_t __segmented_block_size(size_t n) {
+   return n >= 64 ? 8 : (n >= 32 ? 16 : (n >= 16 ? 32 : 512 / n));
+}
+
+template <class T, class Ref, class Ptr, size_t BlockSize>
+struct __segmented_iterator
+    : public iterator<random_access_iterator_tag, T, std::ptrdiff_t, Ptr,
+                      Ref> {
+   typedef __segmented_iterator<T, T&, T*, BlockSize> iterator;
+   typedef __segmented_iterator<T, Ref, Ptr, BlockSize> self;
+   typedef Ref reference;
+   typedef Ptr pointer;
+   typedef std::ptrdiff_t difference_type;
+   typedef T** map_pointer;
+
+   T* cur;    // the element
+   T* first;  // start of its block
+   T* last;   // end of its block
+   map_pointer node;
+
+   __segmented_iterator() : cur(0), first(0), last(0), node(0) {}
+   __segmented_iterator(T* x, map_pointer y)
+       : cur(x), first(*y), last(*y + BlockSize), node(y) {}
+   // iterator to const_iterator; a template, so that the copy constructor
+   // and assignment stay implicit
+   template <class It, class = typename std::enable_if<
+                           std::is_same<It, iterator>::value>::type>
+   __segmented_iterator(const It& x)
+       : cur(x.cur), first(x.first), last(x.last), node(x.node) {}
+
+   void set_node(map_pointer new_node) {
+      node = new_node;
+      first = *new_node;
+      last = first + BlockSize;
+   }
+
+   reference operator*() const { return *cur; }
+   pointer operator->() const { return cur; }
+   reference operator[](difference_type n) const { return *(*this + n); }
+
+   difference_type operator-(const self& x) const {
+      if (node == x.node) return cur - x.cur;
+      return difference_type(BlockSize) * (node - x.node - 1) +
+             (cur - first) + (x.last - x.cur);
+   }
+
+   self& operator++() {
+      if (++cur == last) {
+         set_node(node + 1);
+         cur = first;
+      }
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+   }
+   self& operator--() {
+      if (cur == first) {
+         set_node(node - 1);
+         cur = last;
+      }
+      --cur;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --*this;
+      return tmp;
+   }
+
+   self& operator+=(difference_type n) {
+      const difference_type offset = n + (cur - first);
+      const difference_type size = difference_type(BlockSize);
+      if (offset >= 0 && offset < size) {
+         cur += n;
+      } else {
+         const difference_type node_offset =
+             offset > 0 ? offset / size : -((-offset - 1) / size) - 1;
+         set_node(node + node_offset);
+         cur = first + (offset - node_offset * size);
+      }
+      return *this;
+   }
+   self& operator-=(difference_type n) { return *this += -n; }
+   self operator+(difference_type n) const {
+      self tmp = *this;
+      return tmp += n;
+   }
+   self operator-(difference_type n) const {
+      self tmp = *this;
+      return tmp -= n;
+   }
+
+   bool operator==(const self& x) const { return cur == x.cur; }
+   bool operator!=(const self& x) const { return cur != x.cur; }
+   bool operator<(const self& x) const {
+      return node == x.node ? cur < x.cur : node < x.node;
+   }
+   bool operator>(const self& x) const { return x < *this; }
+   bool operator<=(const self& x) const { return !(x < *this); }
+   bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+// A vector that never moves its elements.
+//
+// The elements live in fixed-size blocks taken from Alloc, and a small
+// index holds the block pointers, so operator[] is a shift, a mask and two
+// loads. Growing only allocates a block and appends to the index: pointers
+// and references stay valid until their element is popped or the
+// container is destroyed. Iterators are invalidated when the index grows.
+// They walk one block at a time with a pointer compare per step, as in
+// SGI's deque.
+//
+// begin() and end() are kept as iterators, so push_back is a pointer bump
+// and a compare until a block fills up. The block past the last element is
+// always allocated so that end() can point into it. Blocks are kept when
+// elements are popped or cleared; shrink_to_fit returns the spare ones.
+template <class T, class Alloc = alloc,
+          size_t BlockSize = __segmented_block_size(sizeof(T))>
+class segmented_vector {
+   static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0,
+                 "segmented_vector block size must be a power of two");
+
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef value_type& reference;
+   typedef const value_type& const_reference;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+   typedef __segmented_iterator<T, T&, T*, BlockSize> iterator;
+   typedef __segmented_iterator<T, const T&, const T*, BlockSize>
+       const_iterator;
+
+  protected:
+   typedef simple_alloc<value_type, Alloc> data_allocator;
+
+   enum { block_size = BlockSize };
+
+   vector<pointer, Alloc> blocks;
+   iterator start;
+   iterator finish;
+
+   iterator make_iterator(size_type i) const {
+      if (blocks.empty()) return iterator();
+      pointer* node = blocks.begin() + i / block_size;
+      return iterator(*node + i % block_size, node);
+   }
+
+   // append a block, the index may move so the iterators are rebuilt
+   void push_block() {
+      const size_type n = size();
+      blocks.push_back(data_allocator::allocate(block_size));
+      start = make_iterator(0);
+      finish = make_iterator(n);
+   }
+
+   // finish is the last slot of its block or there are no blocks yet
+   template <class... Args>
+   void push_back_aux(Args&&... args) {
+      const size_type n = size();
+      while (blocks.size() <= (n + 1) / block_size) push_block();
+      tinystl::construct(finish.cur, std::forward<Args>(args)...);
+      finish = make_iterator(n + 1);
+   }
+
+   template <class Integer>
+   void initialize_aux(Integer n, Integer x, _true_type) {
+      insert_back(static_cast<size_type>(n), x);
+   }
+   template <class InputIterator>
+   void initialize_aux(InputIterator first, InputIterator last, _false_type) {
+      for (; first != last; ++first) push_back(*first);
+   }
+
+   void insert_back(size_type n, const T& x) {
+      reserve(size() + n);
+      for (; n > 0; --n) push_back(x);
+   }
+
+  public:
+   segmented_vector() {}
+   segmented_vector(size_type n, const T& x) { insert_back(n, x); }
+   explicit segmented_vector(size_type n) { insert_back(n, T()); }
+   template <class InputIterator>
+   segmented_vector(InputIterator first, InputIterator last) {
+      typedef typename _is_integer<InputIterator>::integral integral;
+      initialize_aux(first, last, integral());
+   }
+   segmented_vector(const segmented_vector& x) {
+      reserve(x.size());
+      for (const_iterator it = x.begin(); it != x.end(); ++it) push_back(*it);
+   }
+   segmented_vector& operator=(const segmented_vector& x) {
+      if (this != &x) {
+         clear();
+         reserve(x.size());
+         for (const_iterator it = x.begin(); it != x.end(); ++it) {
+            push_back(*it);
+         }
+      }
+      return *this;
+   }
+   ~segmented_vector() {
+      clear();
+      for (size_type k = 0; k < blocks.size(); ++k) {
+         data_allocator::deallocate(blocks[k], block_size);
+      }
+   }
+
+   iterator begin() { return start; }
+   iterator end() { return finish; }
+   const_iterator begin() const { return start; }
+   const_iterator end() const { return finish; }
+
+   size_type size() const { return static_cast<size_type>(finish - start); }
+   bool empty() const { return finish == start; }
+   // elements that fit without allocating, the end block is kept spare
+   size_type capacity() const {
+      return blocks.empty() ? 0 : blocks.size() * block_size - 1;
+   }
+
+   reference operator[](size_type i) {
+      return blocks[i / block_size][i % block_size];
+   }
+   const_reference operator[](size_type i) const {
+      return const_cast<segmented_vector&>(*this)[i];
+   }
+   reference at(size_type i) {
+      assert(i < size() && "segmented_vector index out of range");
+      return (*this)[i];
+   }
+   reference front() { return *start; }
+   reference back() { return *(finish - 1); }
+
+   void push_back(const T& x) {
+      if (finish.last - finish.cur > 1) {
+         tinystl::construct(finish.cur, x);
+         ++finish.cur;
+      } else {
+         push_back_aux(x);
+      }
+   }
+   void push_back(T&& x) {
+      if (finish.last - finish.cur > 1) {
+         tinystl::construct(finish.cur, std::move(x));
+         ++finish.cur;
+      } else {
+         push_back_aux(std::move(x));
+      }
+   }
+   void pop_back() {
+      --finish;
+      tinystl::destroy(finish.cur);
+   }
+
+   void resize(size_type new_size, const T& x) {
+      while (size() > new_size) pop_back();
+      if (new_size > size()) insert_back(new_size - size(), x);
+   }
+   void resize(size_type new_size) { resize(new_size, T()); }
+
+   // allocate the blocks for n elements, none of them ever moves
+   void reserve(size_type n) {
+      while (capacity() < n) push_block();
+   }
+   void clear() {
+      while (finish != start) pop_back();
+   }
+   // free the blocks past the end
+   void shrink_to_fit() {
+      const size_type n = size();
+      const size_type used = n == 0 ? 0 : n / block_size + 1;
+      while (blocks.size() > used) {
+         data_allocator::deallocate(blocks.back(), block_size);
+         blocks.pop_back();
+      }
+      start = make_iterator(0);
+      finish = make_iterator(n);
+   }
+
+   // call f on each contiguous run of elements, block by block
+   template <class Function>
+   void for_each_segment(Function f) {
+      if (start == finish) return;
+      for (pointer* node = start.node; node != finish.node; ++node) {
+         f(*node, *node + block_size);
+      }
+      f(finish.first, finish.cur);
+   }
+};
+}  // namespace tinystl
+
+#endif
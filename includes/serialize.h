@@ -0,0 +1,422 @@
+#ifndef _SERIALIZE_H_
+#define _SERIALIZE_H_
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include "construct.h"
+#include "list.h"
+#include "type_traits.h"
+#include "vector.h"
+
+// Binary persistence of vector and list over POSIX file descriptors.
+//
+// A stream is a 16 byte header followed by the elements. POD elements (see
+// _type_traits::is_POD_type) are stored as raw bytes and moved with a single
+// write/read per vector and writev/readv over the nodes of a list. Other
+// types go through codec<T>, which the user specializes:
+//
+//    template <> struct tinystl::codec<my_type> {
+//       static void encode(byte_writer& out, const my_type& x);
+//       static my_type decode(byte_reader& in);
+//    };
+//
+// Raw streams are only portable between machines with the same layout of T.
+// Several streams can follow each other on one fd; codec streams need the fd
+// to be seekable for that, see byte_reader.
+
+namespace tinystl {
+struct __serial_header {
+   char magic[4];
+   unsigned int elem_size;  // sizeof(T) for raw elements, 0 for codec<T>
+   unsigned long long count;
+};
+
+inline bool __write_all(int fd, const void* buf, size_t n) {
+   const char* p = static_cast<const char*>(buf);
+   while (n > 0) {
+      ssize_t k = ::write(fd, p, n);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) return false;
+      p += k;
+      n -= static_cast<size_t>(k);
+   }
+   return true;
+}
+
+inline bool __read_all(int fd, void* buf, size_t n) {
+   char* p = static_cast<char*>(buf);
+   while (n > 0) {
+      ssize_t k = ::read(fd, p, n);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) return false;
+      p += k;
+      n -= static_cast<size_t>(k);
+   }
+   return true;
+}
+
+// writev/readv all iovecs, advancing through partial transfers
+inline bool __transfer_iov(int fd, struct iovec* iov, int cnt, bool out) {
+   while (cnt > 0) {
+      ssize_t k = out ? ::writev(fd, iov, cnt) : ::readv(fd, iov, cnt);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) return false;
+      size_t done = static_cast<size_t>(k);
+      while (cnt > 0 && done >= iov->iov_len) {
+         done -= iov->iov_len;
+         ++iov;
+         --cnt;
+      }
+      if (cnt > 0) {
+         iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+         iov->iov_len -= done;
+      }
+   }
+   return true;
+}
+
+// buffered writer handed to codec<T>::encode
+class byte_writer {
+  private:
+   enum { buffer_size = 64 * 1024 };
+   int fd;
+   bool ok;
+   size_t used;
+   char buffer[buffer_size];
+
+  public:
+   explicit byte_writer(int f) : fd(f), ok(true), used(0) {}
+   ~byte_writer() { flush(); }
+
+   void write(const void* p, size_t n) {
+      if (used + n > buffer_size) flush();
+      if (n > buffer_size) {
+         ok = ok && __write_all(fd, p, n);
+         return;
+      }
+      std::memcpy(buffer + used, p, n);
+      used += n;
+   }
+   template <class T>
+   void write_pod(const T& x) {
+      write(&x, sizeof(T));
+   }
+   bool flush() {
+      if (used) ok = ok && __write_all(fd, buffer, used);
+      used = 0;
+      return ok;
+   }
+   bool good() const { return ok; }
+};
+
+// buffered reader handed to codec<T>::decode
+//
+// The buffer is refilled in large reads, which can go past the end of the
+// stream. The destructor seeks fd back over the bytes that were read but
+// not consumed, so the next stream on fd starts where this one ended. On a
+// pipe or socket the seek fails and those bytes are lost.
+class byte_reader {
+  private:
+   enum { buffer_size = 64 * 1024 };
+   int fd;
+   bool ok;
+   size_t pos, len;
+   char buffer[buffer_size];
+
+  public:
+   explicit byte_reader(int f) : fd(f), ok(true), pos(0), len(0) {}
+   ~byte_reader() {
+      if (len > pos) ::lseek(fd, -static_cast<off_t>(len - pos), SEEK_CUR);
+   }
+
+   byte_reader(const byte_reader&) = delete;
+   byte_reader& operator=(const byte_reader&) = delete;
+
+   void read(void* p, size_t n) {
+      char* out = static_cast<char*>(p);
+      while (n > 0 && ok) {
+         if (pos == len) {
+            ssize_t k = ::read(fd, buffer, buffer_size);
+            if (k < 0 && errno == EINTR) continue;
+            if (k <= 0) {
+               ok = false;
+               break;
+            }
+            pos = 0;
+            len = static_cast<size_t>(k);
+         }
+         size_t c = len - pos < n ? len - pos : n;
+         std::memcpy(out, buffer + pos, c);
+         pos += c;
+         out += c;
+         n -= c;
+      }
+   }
+   template <class T>
+   T read_pod() {
+      T x = T();
+      read(&x, sizeof(T));
+      return x;
+   }
+   bool good() const { return ok; }
+};
+
+// specialize for every non-POD element type that is serialized
+template <class T>
+struct codec;
+
+// access to the storage of vector and list
+struct __container_io {
+   template <class T, class Alloc>
+   static T*& finish(vector<T, Alloc>& v) {
+      return v.finish;
+   }
+
+   template <class T, class Alloc>
+   static typename list<T, Alloc>::link_type get_node(list<T, Alloc>& l) {
+      return l.get_node();
+   }
+
+   template <class T, class Alloc>
+   static void put_node(list<T, Alloc>& l,
+                        typename list<T, Alloc>::link_type p) {
+      l.put_node(p);
+   }
+
+   // link p in front of the end of l
+   template <class T, class Alloc>
+   static void link_back(list<T, Alloc>& l,
+                         typename list<T, Alloc>::link_type p) {
+      typename list<T, Alloc>::link_type tail = l.node->prev;
+      p->prev = tail;
+      p->next = l.node;
+      tail->next = p;
+      l.node->prev = p;
+   }
+};
+
+inline bool __write_header(int fd, unsigned int elem_size, size_t count) {
+   __serial_header h;
+   std::memcpy(h.magic, "TSTL", 4);
+   h.elem_size = elem_size;
+   h.count = count;
+   return __write_all(fd, &h, sizeof(h));
+}
+
+inline bool __read_header(int fd, unsigned int elem_size, size_t& count) {
+   __serial_header h;
+   if (!__read_all(fd, &h, sizeof(h))) return false;
+   if (std::memcmp(h.magic, "TSTL", 4) != 0 || h.elem_size != elem_size)
+      return false;
+   count = static_cast<size_t>(h.count);
+   return true;
+}
+
+template <class T>
+inline unsigned int __elem_size(_true_type) {
+   return sizeof(T);
+}
+
+template <class T>
+inline unsigned int __elem_size(_false_type) {
+   return 0;
+}
+
+template <class T>
+inline unsigned int __elem_size() {
+   typedef typename _type_traits<T>::is_POD_type is_POD;
+   return __elem_size<T>(is_POD());
+}
+
+// ---------------------------------------------------------------------------
+// vector
+
+template <class T, class Alloc>
+bool __serialize_aux(int fd, const vector<T, Alloc>& v, _true_type) {
+   return __write_all(fd, v.begin(), v.size() * sizeof(T));
+}
+
+template <class T, class Alloc>
+bool __serialize_aux(int fd, const vector<T, Alloc>& v, _false_type) {
+   byte_writer out(fd);
+   for (T* it = v.begin(); it != v.end(); ++it) codec<T>::encode(out, *it);
+   return out.flush();
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const vector<T, Alloc>& v) {
+   typedef typename _type_traits<T>::is_POD_type is_POD;
+   return __write_header(fd, __elem_size<T>(), v.size()) &&
+          __serialize_aux(fd, v, is_POD());
+}
+
+// Reads the elements of a stream written by serialize() in chunks, appending
+// them to a vector: POD elements are read straight into the reserved
+// storage, others are decoded and constructed in place.
+template <class T>
+class vector_reader {
+  private:
+   int fd;
+   bool ok;
+   size_t left;
+   byte_reader* decoder;  // only for codec<T> streams
+
+   // room for n more elements, growing like push_back so that many small
+   // chunks stay linear
+   template <class Alloc>
+   static void __make_room(vector<T, Alloc>& v, size_t n) {
+      if (v.capacity() - v.size() < n)
+         v.reserve(__vector_next_capacity(v.size(), n));
+   }
+
+   template <class Alloc>
+   size_t __read_chunk(vector<T, Alloc>& v, size_t n, _true_type) {
+      __make_room(v, n);
+      T*& finish = __container_io::finish(v);
+      ok = __read_all(fd, finish, n * sizeof(T));
+      if (!ok) return 0;
+      finish += n;
+      return n;
+   }
+
+   template <class Alloc>
+   size_t __read_chunk(vector<T, Alloc>& v, size_t n, _false_type) {
+      __make_room(v, n);
+      T*& finish = __container_io::finish(v);
+      for (size_t i = 0; i < n; ++i) {
+         T x = codec<T>::decode(*decoder);
+         if (!decoder->good()) {
+            ok = false;
+            return i;
+         }
+         construct(finish, std::move(x));
+         ++finish;
+      }
+      return n;
+   }
+
+  public:
+   explicit vector_reader(int f) : fd(f), ok(true), left(0), decoder(0) {
+      ok = __read_header(fd, __elem_size<T>(), left);
+      if (ok && __elem_size<T>() == 0) decoder = new byte_reader(fd);
+   }
+   ~vector_reader() { delete decoder; }
+
+   vector_reader(const vector_reader&) = delete;
+   vector_reader& operator=(const vector_reader&) = delete;
+
+   bool good() const { return ok; }
+   size_t remaining() const { return ok ? left : 0; }
+
+   // append up to max_elems elements to v, returns how many were appended
+   template <class Alloc>
+   size_t read_chunk(vector<T, Alloc>& v, size_t max_elems) {
+      typedef typename _type_traits<T>::is_POD_type is_POD;
+      size_t n = max_elems < left ? max_elems : left;
+      if (!ok || n == 0) return 0;
+      n = __read_chunk(v, n, is_POD());
+      left -= n;
+      return n;
+   }
+};
+
+// replaces the contents of v
+template <class T, class Alloc>
+bool deserialize(int fd, vector<T, Alloc>& v) {
+   v.clear();
+   vector_reader<T> reader(fd);
+   if (!reader.good()) return false;
+   reader.read_chunk(v, reader.remaining());
+   return reader.good() && reader.remaining() == 0;
+}
+
+// ---------------------------------------------------------------------------
+// list
+
+template <class T, class Alloc>
+bool __serialize_aux(int fd, const list<T, Alloc>& l, _true_type) {
+   enum { batch = IOV_MAX < 1024 ? IOV_MAX : 1024 };
+   struct iovec iov[batch];
+   int cnt = 0;
+   for (typename list<T, Alloc>::iterator it = l.begin(); it != l.end();
+        ++it) {
+      iov[cnt].iov_base = &*it;
+      iov[cnt].iov_len = sizeof(T);
+      if (++cnt == batch) {
+         if (!__transfer_iov(fd, iov, cnt, true)) return false;
+         cnt = 0;
+      }
+   }
+   return __transfer_iov(fd, iov, cnt, true);
+}
+
+template <class T, class Alloc>
+bool __serialize_aux(int fd, const list<T, Alloc>& l, _false_type) {
+   byte_writer out(fd);
+   for (typename list<T, Alloc>::iterator it = l.begin(); it != l.end();
+        ++it) {
+      codec<T>::encode(out, *it);
+   }
+   return out.flush();
+}
+
+template <class T, class Alloc>
+bool serialize(int fd, const list<T, Alloc>& l) {
+   typedef typename _type_traits<T>::is_POD_type is_POD;
+   return __write_header(fd, __elem_size<T>(), l.size()) &&
+          __serialize_aux(fd, l, is_POD());
+}
+
+// readv straight into the data of freshly allocated nodes
+template <class T, class Alloc>
+bool __deserialize_aux(int fd, list<T, Alloc>& l, size_t n, _true_type) {
+   typedef typename list<T, Alloc>::link_type link_type;
+   enum { batch = IOV_MAX < 1024 ? IOV_MAX : 1024 };
+   struct iovec iov[batch];
+   link_type nodes[batch];
+   while (n > 0) {
+      int cnt = static_cast<int>(n < size_t(batch) ? n : size_t(batch));
+      for (int i = 0; i < cnt; ++i) {
+         nodes[i] = __container_io::get_node(l);
+         iov[i].iov_base = &nodes[i]->data;
+         iov[i].iov_len = sizeof(T);
+      }
+      if (!__transfer_iov(fd, iov, cnt, false)) {
+         for (int i = 0; i < cnt; ++i) __container_io::put_node(l, nodes[i]);
+         return false;
+      }
+      for (int i = 0; i < cnt; ++i) __container_io::link_back(l, nodes[i]);
+      n -= cnt;
+   }
+   return true;
+}
+
+template <class T, class Alloc>
+bool __deserialize_aux(int fd, list<T, Alloc>& l, size_t n, _false_type) {
+   byte_reader in(fd);
+   for (; n > 0; --n) {
+      T x = codec<T>::decode(in);
+      if (!in.good()) return false;
+      l.push_back(x);
+   }
+   return true;
+}
+
+// replaces the contents of l
+template <class T, class Alloc>
+bool deserialize(int fd, list<T, Alloc>& l) {
+   typedef typename _type_traits<T>::is_POD_type is_POD;
+   l.clear();
+   size_t n;
+   if (!__read_header(fd, __elem_size<T>(), n)) return false;
+   return __deserialize_aux(fd, l, n, is_POD());
+}
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,476 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "type_traits.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define __TINYSTL_X86_KERNELS
+#include <immintrin.h>
+#define __TINYSTL_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Vector kernels for scans over contiguous arithmetic ranges.
+//
+// find, count, minmax_element and accumulate over pointers to 4 and 8 byte
+// integers, floats and doubles land here (see algobase.h and algorithm.h).
+// The kernels are compiled for AVX2 with a target attribute, so no -m flag
+// is needed, and picked at run time when the CPU has it; everything else
+// gets the scalar loops below. The main loops read four vectors a trip.
+
+namespace tinystl {
+enum __simd_isa_t { __isa_scalar, __isa_avx2 };
+
+inline __simd_isa_t __detect_simd_isa() {
+#ifdef __TINYSTL_X86_KERNELS
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2")) return __isa_avx2;
+#endif
+   return __isa_scalar;
+}
+
+// the kernels in use, can be lowered to __isa_scalar
+inline __simd_isa_t& __simd_isa() {
+   static __simd_isa_t isa = __detect_simd_isa();
+   return isa;
+}
+
+// element types with kernels
+template <class U>
+struct __simd_type {
+   typedef typename std::conditional<
+       (std::is_integral<U>::value && !std::is_same<U, bool>::value &&
+        (sizeof(U) == 4 || sizeof(U) == 8)) ||
+           std::is_same<U, float>::value || std::is_same<U, double>::value,
+       _true_type, _false_type>::type type;
+};
+
+// _true_type for pointers to element types with kernels
+template <class Iterator>
+struct __simd_pointer {
+   typedef _false_type type;
+};
+template <class U>
+struct __simd_pointer<U*> : __simd_type<U> {};
+template <class U>
+struct __simd_pointer<const U*> : __simd_type<U> {};
+
+// _true_type when *it == value can be done as *it == U(value), that is
+// when the usual arithmetic conversions take value to U
+template <class U, class T, bool = std::is_arithmetic<T>::value>
+struct __simd_value {
+   typedef _false_type type;
+};
+template <class U, class T>
+struct __simd_value<U, T, true> {
+   typedef typename std::conditional<
+       std::is_same<typename std::common_type<U, T>::type, U>::value,
+       typename __simd_type<U>::type, _false_type>::type type;
+};
+
+template <class Iterator, class T>
+struct __simd_range {
+   typedef _false_type type;
+};
+template <class U, class T>
+struct __simd_range<U*, T> : __simd_value<U, T> {};
+template <class U, class T>
+struct __simd_range<const U*, T> : __simd_value<U, T> {};
+
+// addition that wraps for integers, as the vector lanes do
+template <class U>
+inline U __lane_add(U a, U b, _true_type) {
+   typedef typename std::make_unsigned<U>::type unsigned_type;
+   return static_cast<U>(static_cast<unsigned_type>(a) +
+                         static_cast<unsigned_type>(b));
+}
+template <class U>
+inline U __lane_add(U a, U b, _false_type) {
+   return a + b;
+}
+template <class U>
+inline U __lane_add(U a, U b) {
+   typedef typename std::conditional<std::is_integral<U>::value, _true_type,
+                                     _false_type>::type integral;
+   return __lane_add(a, b, integral());
+}
+
+// ---------------------------------------------------------------------------
+// scalar kernels
+
+template <class U>
+inline const U* __scalar_find(const U* first, const U* last, U value) {
+   while (first != last && !(*first == value)) ++first;
+   return first;
+}
+
+template <class U>
+inline std::ptrdiff_t __scalar_count(const U* first, const U* last, U value) {
+   std::ptrdiff_t n = 0;
+   for (; first != last; ++first) n += *first == value;
+   return n;
+}
+
+// the first smallest and the last largest of a non-empty range
+template <class U>
+inline std::pair<const U*, const U*> __scalar_minmax(const U* first,
+                                                     const U* last) {
+   const U* lo = first;
+   const U* hi = first;
+   for (++first; first != last; ++first) {
+      if (*first < *lo) lo = first;
+      if (!(*first < *hi)) hi = first;
+   }
+   return std::make_pair(lo, hi);
+}
+
+template <class U>
+inline U __scalar_sum(const U* first, const U* last, U init) {
+   for (; first != last; ++first) init = __lane_add(init, *first);
+   return init;
+}
+
+#ifdef __TINYSTL_X86_KERNELS
+// ---------------------------------------------------------------------------
+// AVX2 kernels
+
+// one 256-bit register of U, masks have a bit per lane
+template <class U, size_t Size = sizeof(U),
+          bool Float = std::is_floating_point<U>::value,
+          bool Signed = std::is_signed<U>::value>
+struct __avx2_ops;
+
+template <class U>
+struct __avx2_ops<U, 4, false, true> {
+   typedef __m256i vec;
+   enum { lanes = 8 };
+   __TINYSTL_AVX2 static vec load(const U* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+   }
+   __TINYSTL_AVX2 static void store(U* p, vec a) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+   }
+   __TINYSTL_AVX2 static vec set1(U x) {
+      return _mm256_set1_epi32(static_cast<int>(x));
+   }
+   __TINYSTL_AVX2 static vec zero() { return _mm256_setzero_si256(); }
+   __TINYSTL_AVX2 static int mask(vec a) {
+      return _mm256_movemask_ps(_mm256_castsi256_ps(a));
+   }
+   __TINYSTL_AVX2 static int eq(vec a, vec b) {
+      return mask(_mm256_cmpeq_epi32(a, b));
+   }
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      return mask(_mm256_cmpgt_epi32(b, a));
+   }
+   __TINYSTL_AVX2 static vec min(vec a, vec b) {
+      return _mm256_min_epi32(a, b);
+   }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) {
+      return _mm256_max_epi32(a, b);
+   }
+   __TINYSTL_AVX2 static vec add(vec a, vec b) {
+      return _mm256_add_epi32(a, b);
+   }
+};
+
+template <class U>
+struct __avx2_ops<U, 4, false, false> : __avx2_ops<int, 4, false, true> {
+   typedef __avx2_ops<int, 4, false, true> base;
+   __TINYSTL_AVX2 static vec load(const U* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+   }
+   __TINYSTL_AVX2 static void store(U* p, vec a) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+   }
+   __TINYSTL_AVX2 static vec set1(U x) {
+      return _mm256_set1_epi32(static_cast<int>(x));
+   }
+   // compare signed after flipping the sign bits
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      const vec sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+      return base::lt(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+   }
+   __TINYSTL_AVX2 static vec min(vec a, vec b) {
+      return _mm256_min_epu32(a, b);
+   }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) {
+      return _mm256_max_epu32(a, b);
+   }
+};
+
+template <class U>
+struct __avx2_ops<U, 8, false, true> {
+   typedef __m256i vec;
+   enum { lanes = 4 };
+   __TINYSTL_AVX2 static vec load(const U* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+   }
+   __TINYSTL_AVX2 static void store(U* p, vec a) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+   }
+   __TINYSTL_AVX2 static vec set1(U x) {
+      return _mm256_set1_epi64x(static_cast<long long>(x));
+   }
+   __TINYSTL_AVX2 static vec zero() { return _mm256_setzero_si256(); }
+   __TINYSTL_AVX2 static int mask(vec a) {
+      return _mm256_movemask_pd(_mm256_castsi256_pd(a));
+   }
+   __TINYSTL_AVX2 static int eq(vec a, vec b) {
+      return mask(_mm256_cmpeq_epi64(a, b));
+   }
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      return mask(_mm256_cmpgt_epi64(b, a));
+   }
+   // no 64-bit min and max before AVX-512
+   __TINYSTL_AVX2 static vec min(vec a, vec b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+   }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+   }
+   __TINYSTL_AVX2 static vec add(vec a, vec b) {
+      return _mm256_add_epi64(a, b);
+   }
+};
+
+template <class U>
+struct __avx2_ops<U, 8, false, false> : __avx2_ops<long long, 8, false, true> {
+   typedef __avx2_ops<long long, 8, false, true> base;
+   __TINYSTL_AVX2 static vec load(const U* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+   }
+   __TINYSTL_AVX2 static void store(U* p, vec a) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+   }
+   __TINYSTL_AVX2 static vec set1(U x) {
+      return _mm256_set1_epi64x(static_cast<long long>(x));
+   }
+   __TINYSTL_AVX2 static vec flip(vec a) {
+      return _mm256_xor_si256(
+          a, _mm256_set1_epi64x(static_cast<long long>(1ULL << 63)));
+   }
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      return base::lt(flip(a), flip(b));
+   }
+   __TINYSTL_AVX2 static vec min(vec a, vec b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(flip(a), flip(b)));
+   }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(flip(b), flip(a)));
+   }
+};
+
+template <>
+struct __avx2_ops<float, 4, true, true> {
+   typedef __m256 vec;
+   enum { lanes = 8 };
+   __TINYSTL_AVX2 static vec load(const float* p) { return _mm256_loadu_ps(p); }
+   __TINYSTL_AVX2 static void store(float* p, vec a) { _mm256_storeu_ps(p, a); }
+   __TINYSTL_AVX2 static vec set1(float x) { return _mm256_set1_ps(x); }
+   __TINYSTL_AVX2 static vec zero() { return _mm256_setzero_ps(); }
+   __TINYSTL_AVX2 static int eq(vec a, vec b) {
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+   }
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+   }
+   __TINYSTL_AVX2 static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+   __TINYSTL_AVX2 static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+};
+
+template <>
+struct __avx2_ops<double, 8, true, true> {
+   typedef __m256d vec;
+   enum { lanes = 4 };
+   __TINYSTL_AVX2 static vec load(const double* p) {
+      return _mm256_loadu_pd(p);
+   }
+   __TINYSTL_AVX2 static void store(double* p, vec a) {
+      _mm256_storeu_pd(p, a);
+   }
+   __TINYSTL_AVX2 static vec set1(double x) { return _mm256_set1_pd(x); }
+   __TINYSTL_AVX2 static vec zero() { return _mm256_setzero_pd(); }
+   __TINYSTL_AVX2 static int eq(vec a, vec b) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+   }
+   __TINYSTL_AVX2 static int lt(vec a, vec b) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+   }
+   __TINYSTL_AVX2 static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+   __TINYSTL_AVX2 static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+   __TINYSTL_AVX2 static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+};
+
+// masks of four vectors in one word, lane order kept
+template <int Lanes>
+inline unsigned long long __join_masks(int m0, int m1, int m2, int m3) {
+   return static_cast<unsigned long long>(m0) |
+          static_cast<unsigned long long>(m1) << Lanes |
+          static_cast<unsigned long long>(m2) << 2 * Lanes |
+          static_cast<unsigned long long>(m3) << 3 * Lanes;
+}
+
+template <class U>
+__TINYSTL_AVX2 const U* __avx2_find(const U* first, const U* last, U value) {
+   typedef __avx2_ops<U> ops;
+   const std::ptrdiff_t n = ops::lanes;
+   const typename ops::vec x = ops::set1(value);
+   for (; last - first >= 4 * n; first += 4 * n) {
+      const int m0 = ops::eq(ops::load(first), x);
+      const int m1 = ops::eq(ops::load(first + n), x);
+      const int m2 = ops::eq(ops::load(first + 2 * n), x);
+      const int m3 = ops::eq(ops::load(first + 3 * n), x);
+      if (m0 | m1 | m2 | m3) {
+         return first +
+                __builtin_ctzll(__join_masks<ops::lanes>(m0, m1, m2, m3));
+      }
+   }
+   for (; last - first >= n; first += n) {
+      const int m = ops::eq(ops::load(first), x);
+      if (m) return first + __builtin_ctz(m);
+   }
+   return __scalar_find(first, last, value);
+}
+
+template <class U>
+__TINYSTL_AVX2 std::ptrdiff_t __avx2_count(const U* first, const U* last,
+                                           U value) {
+   typedef __avx2_ops<U> ops;
+   const std::ptrdiff_t n = ops::lanes;
+   const typename ops::vec x = ops::set1(value);
+   std::ptrdiff_t result = 0;
+   for (; last - first >= 4 * n; first += 4 * n) {
+      result += __builtin_popcountll(__join_masks<ops::lanes>(
+          ops::eq(ops::load(first), x), ops::eq(ops::load(first + n), x),
+          ops::eq(ops::load(first + 2 * n), x),
+          ops::eq(ops::load(first + 3 * n), x)));
+   }
+   for (; last - first >= n; first += n) {
+      result += __builtin_popcount(ops::eq(ops::load(first), x));
+   }
+   return result + __scalar_count(first, last, value);
+}
+
+// Blocks of four vectors are reduced to a lane-wise min and max. Only a
+// block with a new smallest value (or a largest one at least as large as
+// the current) is reduced further and remembered, and at the end the two
+// remembered blocks are searched for the first smallest and the last largest
+// element, as in std::minmax_element. A NaN breaks that ordering, so a
+// reduced value that is not equal to itself, or one that isn't found again
+// in its block, hands the range to the scalar loop.
+template <class U>
+__TINYSTL_AVX2 std::pair<const U*, const U*> __avx2_minmax(const U* first,
+                                                           const U* last) {
+   typedef __avx2_ops<U> ops;
+   typedef typename ops::vec vec;
+   const std::ptrdiff_t n = ops::lanes;
+   const std::ptrdiff_t block = 4 * n;
+   const int all = (1 << ops::lanes) - 1;
+   U lanes[ops::lanes];
+
+   const U* const start = first;
+   const U* lo = first;
+   const U* hi = first;
+   if (last - first >= block) {
+      U lo_value = *first, hi_value = *first;
+      const U* lo_block = first;
+      const U* hi_block = first;
+      for (; last - first >= block; first += block) {
+         const vec v0 = ops::load(first), v1 = ops::load(first + n);
+         const vec v2 = ops::load(first + 2 * n), v3 = ops::load(first + 3 * n);
+         const vec mn = ops::min(ops::min(v0, v1), ops::min(v2, v3));
+         const vec mx = ops::max(ops::max(v0, v1), ops::max(v2, v3));
+         if (ops::lt(mn, ops::set1(lo_value))) {
+            ops::store(lanes, mn);
+            lo_value = *__scalar_minmax(lanes, lanes + n).first;
+            lo_block = first;
+         }
+         if (ops::lt(mx, ops::set1(hi_value)) != all) {
+            ops::store(lanes, mx);
+            hi_value = *__scalar_minmax(lanes, lanes + n).second;
+            hi_block = first;
+         }
+         if (!(lo_value == lo_value) || !(hi_value == hi_value))
+            return __scalar_minmax(start, last);
+      }
+      lo = __scalar_find(lo_block, lo_block + block, lo_value);
+      for (hi = hi_block + block - 1; hi != hi_block && !(*hi == hi_value);
+           --hi) {
+      }
+      if (lo == lo_block + block || !(*hi == hi_value))
+         return __scalar_minmax(start, last);
+   }
+   for (; first != last; ++first) {
+      if (*first < *lo) lo = first;
+      if (!(*first < *hi)) hi = first;
+   }
+   return std::make_pair(lo, hi);
+}
+
+// Sums in four vector accumulators. Floating point sums are therefore
+// rounded in a different order than a left fold, like -ffast-math would.
+template <class U>
+__TINYSTL_AVX2 U __avx2_sum(const U* first, const U* last, U init) {
+   typedef __avx2_ops<U> ops;
+   typedef typename ops::vec vec;
+   const std::ptrdiff_t n = ops::lanes;
+   vec a0 = ops::zero(), a1 = ops::zero(), a2 = ops::zero(),
+       a3 = ops::zero();
+   for (; last - first >= 4 * n; first += 4 * n) {
+      a0 = ops::add(a0, ops::load(first));
+      a1 = ops::add(a1, ops::load(first + n));
+      a2 = ops::add(a2, ops::load(first + 2 * n));
+      a3 = ops::add(a3, ops::load(first + 3 * n));
+   }
+   for (; last - first >= n; first += n) a0 = ops::add(a0, ops::load(first));
+   a0 = ops::add(ops::add(a0, a1), ops::add(a2, a3));
+   U lanes[ops::lanes];
+   ops::store(lanes, a0);
+   init = __scalar_sum(lanes, lanes + n, init);
+   return __scalar_sum(first, last, init);
+}
+#endif  // __TINYSTL_X86_KERNELS
+
+// ---------------------------------------------------------------------------
+// dispatch
+
+template <class U>
+inline const U* __simd_find(const U* first, const U* last, U value) {
+#ifdef __TINYSTL_X86_KERNELS
+   if (__simd_isa() == __isa_avx2) return __avx2_find(first, last, value);
+#endif
+   return __scalar_find(first, last, value);
+}
+
+template <class U>
+inline std::ptrdiff_t __simd_count(const U* first, const U* last, U value) {
+#ifdef __TINYSTL_X86_KERNELS
+   if (__simd_isa() == __isa_avx2) return __avx2_count(first, last, value);
+#endif
+   return __scalar_count(first, last, value);
+}
+
+// first != last
+template <class U>
+inline std::pair<const U*, const U*> __simd_minmax(const U* first,
+                                                   const U* last) {
+#ifdef __TINYSTL_X86_KERNELS
+   if (__simd_isa() == __isa_avx2) return __avx2_minmax(first, last);
+#endif
+   return __scalar_minmax(first, last);
+}
+
+template <class U>
+inline U __simd_sum(const U* first, const U* last, U init) {
+#ifdef __TINYSTL_X86_KERNELS
+   if (__simd_isa() == __isa_avx2) return __avx2_sum(first, last, init);
+#endif
+   return __scalar_sum(first, last, init);
+}
+}  // namespace tinystl
+
+#endif
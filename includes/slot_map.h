@@ -0,0 +1,163 @@
+#ifndef _SLOT_MAP_H_
+#define _SLOT_MAP_H_
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "allocator.h"
+#include "vector.h"
+
+namespace tinystl {
+// a handle into a slot_map, live generations are odd so a zero key is
+// always stale
+struct slot_key {
+   uint32_t index;
+   uint32_t generation;
+
+   bool operator==(const slot_key& x) const {
+      return index == x.index && generation == x.generation;
+   }
+   bool operator!=(const slot_key& x) const { return !(*this == x); }
+};
+
+struct __slot {
+   uint32_t index;       // dense position when live, next free slot if not
+   uint32_t generation;  // odd while live, bumped on insert and erase
+};
+
+// Stable handles to values that are stored densely.
+//
+// The values live in one vector, so iterating a slot_map is iterating an
+// array. A handle names a slot of a sparse vector, which holds the value's
+// dense position and a generation. Erase moves the last value into the
+// hole (swap-and-pop), fixes that value's slot through the dense-to-slot
+// back index, and bumps the generation of the erased slot, so every old
+// handle to it is detected as stale. Free slots are chained through their
+// index field and reused first. Insert, erase and lookup are O(1).
+//
+// Erase changes the order of the values and invalidates iterators and
+// pointers to them, never handles. A slot reused 2^31 times wraps its
+// generation and could accept a handle that old.
+template <class T, class Alloc = alloc>
+class slot_map {
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef value_type* iterator;
+   typedef value_type& reference;
+   typedef size_t size_type;
+   typedef slot_key key_type;
+
+  protected:
+   static const uint32_t no_slot = ~uint32_t(0);
+
+   vector<T, Alloc> values;
+   vector<uint32_t, Alloc> slot_of;  // slot of each value, by dense position
+   vector<__slot, Alloc> slots;
+   uint32_t free_head;
+
+   // the slot of a live key, null for a stale one
+   __slot* live_slot(const slot_key& k) const {
+      if (k.index >= slots.size()) return 0;
+      __slot* s = slots.begin() + k.index;
+      return s->generation == k.generation && (k.generation & 1) ? s : 0;
+   }
+   void free_slot(uint32_t i) {
+      __slot& s = slots[i];
+      ++s.generation;
+      s.index = free_head;
+      free_head = i;
+   }
+
+  public:
+   slot_map() : free_head(no_slot) {}
+
+   slot_map(const slot_map&) = delete;
+   slot_map& operator=(const slot_map&) = delete;
+
+   iterator begin() const { return values.begin(); }
+   iterator end() const { return values.end(); }
+   size_type size() const { return values.size(); }
+   bool empty() const { return values.empty(); }
+   // slots ever handed out, live or free
+   size_type slot_count() const { return slots.size(); }
+
+   void reserve(size_type n) {
+      values.reserve(n);
+      slot_of.reserve(n);
+      slots.reserve(n);
+   }
+
+   slot_key insert(const T& x) {
+      if (free_head == no_slot) {
+         // a new slot joins the free list first, a throw below leaves it
+         // there
+         __slot s = {no_slot, 0};
+         slots.push_back(s);
+         free_head = static_cast<uint32_t>(slots.size() - 1);
+      }
+      const uint32_t i = free_head;
+      values.push_back(x);
+      try {
+         slot_of.push_back(i);
+      } catch (...) {
+         values.pop_back();
+         throw;
+      }
+      __slot& s = slots[i];
+      free_head = s.index;
+      s.index = static_cast<uint32_t>(values.size() - 1);
+      ++s.generation;
+      slot_key k = {i, s.generation};
+      return k;
+   }
+
+   // false for a stale key
+   bool erase(const slot_key& k) {
+      __slot* s = live_slot(k);
+      if (!s) return false;
+      const uint32_t pos = s->index;
+      const uint32_t last = static_cast<uint32_t>(values.size() - 1);
+      if (pos != last) {
+         values[pos] = std::move(values[last]);
+         slot_of[pos] = slot_of[last];
+         slots[slot_of[pos]].index = pos;
+      }
+      values.pop_back();
+      slot_of.pop_back();
+      free_slot(k.index);
+      return true;
+   }
+
+   // the value of k, null for a stale key
+   T* find(const slot_key& k) const {
+      __slot* s = live_slot(k);
+      return s ? values.begin() + s->index : 0;
+   }
+   bool contains(const slot_key& k) const { return live_slot(k) != 0; }
+   reference operator[](const slot_key& k) const {
+      T* p = find(k);
+      assert(p && "stale slot_map key");
+      return *p;
+   }
+
+   // the handle of the value at it
+   slot_key key_of(iterator it) const {
+      const uint32_t i = slot_of.begin()[it - begin()];
+      slot_key k = {i, slots.begin()[i].generation};
+      return k;
+   }
+
+   // erase everything, every handle goes stale
+   void clear() {
+      for (size_type p = 0; p < slot_of.size(); ++p) {
+         free_slot(slot_of.begin()[p]);
+      }
+      values.clear();
+      slot_of.clear();
+   }
+};
+}  // namespace tinystl
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef _SOA_VECTOR_H_
+#define _SOA_VECTOR_H_
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace tinystl {
+// contiguous run of one column, e.g. for the kernels in algorithm.h
+template <class T>
+struct column_span {
+   T* ptr;
+   size_t len;
+
+   T* begin() const { return ptr; }
+   T* end() const { return ptr + len; }
+   T* data() const { return ptr; }
+   size_t size() const { return len; }
+   bool empty() const { return len == 0; }
+   T& operator[](size_t n) const { return ptr[n]; }
+};
+
+// proxy for one row: assigning through it writes every column
+template <class... Ts>
+class __soa_reference {
+  public:
+   typedef std::tuple<Ts...> value_type;
+
+  private:
+   std::tuple<Ts&...> refs;
+
+  public:
+   explicit __soa_reference(Ts&... xs) : refs(xs...) {}
+   __soa_reference(const __soa_reference&) = default;
+
+   // tuple of references assigns the referenced values
+   __soa_reference& operator=(const __soa_reference& x) {
+      refs = x.refs;
+      return *this;
+   }
+   __soa_reference& operator=(const value_type& x) {
+      refs = x;
+      return *this;
+   }
+   operator value_type() const { return value_type(refs); }
+
+   template <size_t I>
+   typename std::tuple_element<I, value_type>::type& get() const {
+      return std::get<I>(refs);
+   }
+
+   friend void swap(__soa_reference a, __soa_reference b) {
+      a.refs.swap(b.refs);
+   }
+   friend bool operator==(const __soa_reference& a, const __soa_reference& b) {
+      return a.refs == b.refs;
+   }
+   friend bool operator!=(const __soa_reference& a, const __soa_reference& b) {
+      return a.refs != b.refs;
+   }
+   friend bool operator<(const __soa_reference& a, const __soa_reference& b) {
+      return a.refs < b.refs;
+   }
+};
+
+template <size_t I, class... Ts>
+inline typename std::tuple_element<I, std::tuple<Ts...>>::type& get(
+    const __soa_reference<Ts...>& r) {
+   return r.template get<I>();
+}
+
+template <class... Ts>
+struct __soa_iterator
+    : public iterator<random_access_iterator_tag, std::tuple<Ts...>,
+                      std::ptrdiff_t, void, __soa_reference<Ts...>> {
+   typedef __soa_iterator<Ts...> self;
+   typedef __soa_reference<Ts...> reference;
+   typedef std::ptrdiff_t difference_type;
+   typedef std::tuple<Ts*...> columns_type;
+
+   const columns_type* columns;
+   difference_type pos;
+
+   __soa_iterator() : columns(0), pos(0) {}
+   __soa_iterator(const columns_type* c, difference_type n)
+       : columns(c), pos(n) {}
+
+   template <size_t... I>
+   reference deref(difference_type n, std::index_sequence<I...>) const {
+      return reference(std::get<I>(*columns)[n]...);
+   }
+
+   reference operator*() const {
+      return deref(pos, std::index_sequence_for<Ts...>());
+   }
+   reference operator[](difference_type n) const {
+      return deref(pos + n, std::index_sequence_for<Ts...>());
+   }
+
+   self& operator++() {
+      ++pos;
+      return *this;
+   }
+   self operator++(int) {
+      self tmp = *this;
+      ++pos;
+      return tmp;
+   }
+   self& operator--() {
+      --pos;
+      return *this;
+   }
+   self operator--(int) {
+      self tmp = *this;
+      --pos;
+      return tmp;
+   }
+   self& operator+=(difference_type n) {
+      pos += n;
+      return *this;
+   }
+   self& operator-=(difference_type n) {
+      pos -= n;
+      return *this;
+   }
+   self operator+(difference_type n) const { return self(columns, pos + n); }
+   self operator-(difference_type n) const { return self(columns, pos - n); }
+   difference_type operator-(const self& x) const { return pos - x.pos; }
+
+   bool operator==(const self& x) const { return pos == x.pos; }
+   bool operator!=(const self& x) const { return pos != x.pos; }
+   bool operator<(const self& x) const { return pos < x.pos; }
+   bool operator>(const self& x) const { return pos > x.pos; }
+   bool operator<=(const self& x) const { return pos <= x.pos; }
+   bool operator>=(const self& x) const { return pos >= x.pos; }
+};
+
+// Structure of arrays: row i of a soa_vector<Ts...> is stored as element i
+// of one array per type in Ts, so a loop over a single field streams through
+// that field only.
+//
+// All columns share one block from simple_alloc and start on a
+// column_alignment boundary. They grow together with the growth policy of
+// vector. Rows are read and written through a proxy reference; column<I>()
+// hands out the raw array of field I.
+template <class Alloc, class... Ts>
+class basic_soa_vector {
+   static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+  public:
+   typedef std::tuple<Ts...> value_type;
+   typedef __soa_reference<Ts...> reference;
+   typedef __soa_iterator<Ts...> iterator;
+   typedef size_t size_type;
+   typedef std::ptrdiff_t difference_type;
+
+   enum { column_alignment = 64 };
+
+   template <size_t I>
+   using column_type = typename std::tuple_element<I, value_type>::type;
+
+  protected:
+   typedef simple_alloc<char, Alloc> data_allocator;
+   typedef std::tuple<Ts*...> columns_type;
+   typedef std::index_sequence_for<Ts...> indices;
+
+   columns_type columns;
+   char* block;
+   size_type block_bytes;
+   size_type len, cap;
+
+   static size_type round_up(size_type bytes) {
+      return (bytes + column_alignment - 1) &
+             ~static_cast<size_type>(column_alignment - 1);
+   }
+
+   // bytes for n rows, slack included for aligning the first column
+   static size_type block_size(size_type n) {
+      size_type bytes = column_alignment;
+      for (size_type column : {round_up(n * sizeof(Ts))...}) bytes += column;
+      return bytes;
+   }
+
+   template <class T>
+   static T* take(char*& p, size_type n) {
+      T* column = reinterpret_cast<T*>(p);
+      p += round_up(n * sizeof(T));
+      return column;
+   }
+
+   static columns_type carve(char* p, size_type n) {
+      size_t addr = reinterpret_cast<size_t>(p);
+      p += round_up(addr) - addr;
+      // braced initialization keeps the columns in order
+      return columns_type{take<Ts>(p, n)...};
+   }
+
+   template <size_t... I>
+   void copy_columns(const columns_type& to, std::index_sequence<I...>) {
+      (void)std::initializer_list<int>{
+          (tinystl::uninitialized_copy(std::get<I>(columns),
+                                       std::get<I>(columns) + len,
+                                       std::get<I>(to)),
+           0)...};
+   }
+
+   template <size_t... I>
+   void destroy_rows(size_type first, size_type last,
+                     std::index_sequence<I...>) {
+      (void)std::initializer_list<int>{
+          (tinystl::destroy(std::get<I>(columns) + first,
+                            std::get<I>(columns) + last),
+           0)...};
+   }
+
+   template <size_t... I>
+   void construct_row(std::index_sequence<I...>, const Ts&... xs) {
+      (void)std::initializer_list<int>{
+          (tinystl::construct(std::get<I>(columns) + len, xs), 0)...};
+   }
+
+   template <size_t... I>
+   void construct_row(std::index_sequence<I...>) {
+      (void)std::initializer_list<int>{
+          (tinystl::construct(std::get<I>(columns) + len), 0)...};
+   }
+
+   template <size_t... I>
+   void push_tuple(const value_type& x, std::index_sequence<I...>) {
+      push_back(std::get<I>(x)...);
+   }
+
+   template <size_t... I>
+   reference row(size_type n, std::index_sequence<I...>) const {
+      return reference(std::get<I>(columns)[n]...);
+   }
+
+   void reallocate(size_type n) {
+      const size_type bytes = block_size(n);
+      char* new_block = data_allocator::allocate(bytes);
+      columns_type new_columns = carve(new_block, n);
+      try {
+         copy_columns(new_columns, indices());
+      } catch (...) {
+         data_allocator::deallocate(new_block, bytes);
+         throw;
+      }
+      destroy_rows(0, len, indices());
+      data_allocator::deallocate(block, block_bytes);
+
+      columns = new_columns;
+      block = new_block;
+      block_bytes = bytes;
+      cap = n;
+   }
+
+  public:
+   basic_soa_vector() : block(0), block_bytes(0), len(0), cap(0) {}
+   ~basic_soa_vector() {
+      destroy_rows(0, len, indices());
+      data_allocator::deallocate(block, block_bytes);
+   }
+
+   basic_soa_vector(const basic_soa_vector&) = delete;
+   basic_soa_vector& operator=(const basic_soa_vector&) = delete;
+
+   iterator begin() const { return iterator(&columns, 0); }
+   iterator end() const { return iterator(&columns, len); }
+   size_type size() const { return len; }
+   size_type capacity() const { return cap; }
+   bool empty() const { return len == 0; }
+   reference operator[](size_type n) const { return row(n, indices()); }
+   reference front() const { return row(0, indices()); }
+   reference back() const { return row(len - 1, indices()); }
+
+   // the contiguous array of field I
+   template <size_t I>
+   column_type<I>* data() const {
+      return std::get<I>(columns);
+   }
+   template <size_t I>
+   column_span<column_type<I>> column() const {
+      column_span<column_type<I>> span = {std::get<I>(columns), len};
+      return span;
+   }
+
+   void reserve(size_type n) {
+      if (n > cap) reallocate(n);
+   }
+
+   void push_back(const Ts&... xs) {
+      if (len == cap) reallocate(__vector_next_capacity(len, 1));
+      construct_row(indices(), xs...);
+      ++len;
+   }
+   void push_back(const value_type& x) { push_tuple(x, indices()); }
+
+   void pop_back() {
+      --len;
+      destroy_rows(len, len + 1, indices());
+   }
+
+   // new rows are value-initialized
+   void resize(size_type n) {
+      if (n < len) {
+         destroy_rows(n, len, indices());
+         len = n;
+         return;
+      }
+      if (n > cap) reallocate(__vector_next_capacity(len, n - len));
+      for (; len < n; ++len) construct_row(indices());
+   }
+
+   void clear() {
+      destroy_rows(0, len, indices());
+      len = 0;
+   }
+};
+
+template <class... Ts>
+using soa_vector = basic_soa_vector<alloc, Ts...>;
+}  // namespace tinystl
+
+#endif
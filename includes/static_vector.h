@@ -0,0 +1,233 @@
+#ifndef _STATIC_VECTOR_H_
+#define _STATIC_VECTOR_H_
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "construct.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+
+// what a push or insert beyond the capacity does, define it before the
+// include to abort or log instead
+#ifndef __STATIC_VECTOR_OVERFLOW
+#include <stdexcept>
+#define __STATIC_VECTOR_OVERFLOW \
+   throw std::length_error("static_vector is full");
+#endif
+
+namespace tinystl {
+// trivial T: a plain array, so that the element-wise operations can be
+// evaluated at compile time
+template <class T, size_t N, bool trivial = std::is_trivial<T>::value>
+struct __static_vector_storage {
+   T elems[N];
+   size_t count;
+
+#if __cpp_constexpr >= 201907L
+   constexpr __static_vector_storage() : count(0) {}
+#else
+   // before C++20 a constexpr constructor has to initialize every element
+   constexpr __static_vector_storage() : elems(), count(0) {}
+#endif
+
+   constexpr T* data() { return elems; }
+   constexpr const T* data() const { return elems; }
+   constexpr void construct_at(size_t i, const T& x) { elems[i] = x; }
+   constexpr void destroy_range(size_t, size_t) {}
+};
+
+// other T: raw aligned bytes, elements are constructed in place
+template <class T, size_t N>
+struct __static_vector_storage<T, N, false> {
+   alignas(T) unsigned char bytes[N * sizeof(T)];
+   size_t count;
+
+   __static_vector_storage() : count(0) {}
+   __static_vector_storage(const __static_vector_storage& x) : count(0) {
+      tinystl::uninitialized_copy(x.data(), x.data() + x.count, data());
+      count = x.count;
+   }
+   __static_vector_storage& operator=(const __static_vector_storage& x) {
+      if (this != &x) {
+         destroy_range(0, count);
+         count = 0;
+         tinystl::uninitialized_copy(x.data(), x.data() + x.count, data());
+         count = x.count;
+      }
+      return *this;
+   }
+   ~__static_vector_storage() { destroy_range(0, count); }
+
+   T* data() { return reinterpret_cast<T*>(bytes); }
+   const T* data() const { return reinterpret_cast<const T*>(bytes); }
+   void construct_at(size_t i, const T& x) {
+      tinystl::construct(data() + i, x);
+   }
+   void destroy_range(size_t first, size_t last) {
+      tinystl::destroy(data() + first, data() + last);
+   }
+};
+
+// A vector with room for N elements inside the object and no allocator.
+//
+// The interface follows vector. Growing past N runs
+// __STATIC_VECTOR_OVERFLOW, which throws std::length_error by default and
+// leaves the contents as they were; try_push_back reports a full vector
+// instead. Bulk copies go through uninitialized.h, so POD elements are
+// moved with memmove.
+//
+// For trivial T the storage is a plain array and the object is a literal
+// type: construction, push_back, pop_back, element access, resize and
+// clear are constexpr.
+template <class T, size_t N>
+class static_vector : protected __static_vector_storage<T, N> {
+   static_assert(N > 0, "static_vector needs a capacity");
+   typedef __static_vector_storage<T, N> base;
+
+  public:
+   typedef T value_type;
+   typedef value_type* pointer;
+   typedef value_type* iterator;
+   typedef value_type& reference;
+   typedef size_t size_type;
+   typedef ptrdiff_t difference_type;
+
+  protected:
+   using base::count;
+   using base::construct_at;
+   using base::destroy_range;
+
+   constexpr void check_room(size_type n) const {
+      if (n > N - count) {
+         __STATIC_VECTOR_OVERFLOW
+      }
+   }
+   template <class Integer>
+   void initialize_aux(Integer n, Integer value, _true_type) {
+      insert(end(), static_cast<size_type>(n), value);
+   }
+   template <class InputIterator>
+   void initialize_aux(InputIterator first, InputIterator last, _false_type) {
+      for (; first != last; ++first) push_back(*first);
+   }
+
+  public:
+   constexpr static_vector() {}
+   constexpr static_vector(std::initializer_list<T> values) {
+      check_room(values.size());
+      for (const T* it = values.begin(); it != values.end(); ++it) {
+         construct_at(count++, *it);
+      }
+   }
+   constexpr static_vector(size_type n, const T& value) { resize(n, value); }
+   constexpr explicit static_vector(size_type n) { resize(n, T()); }
+   template <class InputIterator>
+   static_vector(InputIterator first, InputIterator last) {
+      typedef typename _is_integer<InputIterator>::integral integral;
+      initialize_aux(first, last, integral());
+   }
+
+   constexpr iterator begin() { return base::data(); }
+   constexpr iterator end() { return base::data() + count; }
+   constexpr const T* begin() const { return base::data(); }
+   constexpr const T* end() const { return base::data() + count; }
+   constexpr pointer data() { return base::data(); }
+   constexpr const T* data() const { return base::data(); }
+
+   constexpr size_type size() const { return count; }
+   static constexpr size_type capacity() { return N; }
+   static constexpr size_type max_size() { return N; }
+   constexpr bool empty() const { return count == 0; }
+   constexpr bool full() const { return count == N; }
+
+   constexpr reference operator[](size_type n) { return base::data()[n]; }
+   constexpr const T& operator[](size_type n) const {
+      return base::data()[n];
+   }
+   constexpr reference front() { return *begin(); }
+   constexpr reference back() { return *(end() - 1); }
+   constexpr reference at(int pos) { return *(begin() + pos); }
+
+   constexpr void push_back(const T& x) {
+      check_room(1);
+      construct_at(count, x);
+      ++count;
+   }
+   // false and nothing pushed when full
+   constexpr bool try_push_back(const T& x) {
+      if (count == N) return false;
+      construct_at(count, x);
+      ++count;
+      return true;
+   }
+   constexpr void pop_back() {
+      --count;
+      destroy_range(count, count + 1);
+   }
+
+   // the storage is fixed, only checks that n elements fit
+   constexpr void reserve(size_type n) const {
+      if (n > N) {
+         __STATIC_VECTOR_OVERFLOW
+      }
+   }
+
+   iterator insert(iterator pos, const T& x) {
+      const size_type i = static_cast<size_type>(pos - begin());
+      insert(pos, 1, x);
+      return begin() + i;
+   }
+
+   void insert(iterator pos, size_type n, const T& x) {
+      if (n == 0) return;
+      __OP_SCOPE("static_vector::insert");
+      check_room(n);
+      T x_copy = x;
+      iterator finish = end();
+      const size_type elems_after = static_cast<size_type>(finish - pos);
+      if (elems_after > n) {
+         tinystl::uninitialized_copy(finish - n, finish, finish);
+         count += n;
+         tinystl::copy_backward(pos, finish - n, finish);
+         tinystl::fill(pos, pos + n, x_copy);
+      } else {
+         tinystl::uninitialized_fill_n(finish, n - elems_after, x_copy);
+         count += n - elems_after;
+         tinystl::uninitialized_copy(pos, finish, end());
+         count += elems_after;
+         tinystl::fill(pos, finish, x_copy);
+      }
+   }
+
+   iterator erase(iterator pos) { return erase(pos, pos + 1); }
+
+   iterator erase(iterator first, iterator last) {
+      __OP_SCOPE("static_vector::erase");
+      iterator i = tinystl::copy(last, end(), first);
+      const size_type new_count = static_cast<size_type>(i - begin());
+      destroy_range(new_count, count);
+      count = new_count;
+      return first;
+   }
+
+   constexpr void resize(size_type new_size, const T& x) {
+      if (new_size < count) {
+         destroy_range(new_size, count);
+         count = new_size;
+      } else {
+         check_room(new_size - count);
+         while (count < new_size) construct_at(count++, x);
+      }
+   }
+   constexpr void resize(size_type new_size) { resize(new_size, T()); }
+   constexpr void clear() {
+      destroy_range(0, count);
+      count = 0;
+   }
+};
+}  // namespace tinystl
+
+#endif
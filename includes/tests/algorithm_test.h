@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "algorithm.h"
+#include "list.h"
+#include "rtest.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SORT_TEST_SIZE 1000
+struct record {
+   int key;
+   int id;
+   bool operator==(const record& x) const {
+      return key == x.key && id == x.id;
+   }
+};
+
+// find, count, minmax_element and accumulate against std::, with the
+// vector kernels and with the scalar fallback
+template <class T>
+void check_scans(T scale) {
+   const tinystl::__simd_isa_t detected = tinystl::__simd_isa();
+   const int sizes[] = {0, 1, 7, 33, 100, SORT_TEST_SIZE};
+   for (int pass = 0; pass < 2; ++pass) {
+      if (pass == 1) tinystl::__simd_isa() = tinystl::__isa_scalar;
+      for (int n : sizes) {
+         std::vector<T> std_vector;
+         for (int i = 0; i < n; ++i) {
+            std_vector.push_back(
+                static_cast<T>(rtest::Tester::get_random_int(-100, 100)) *
+                scale);
+         }
+         tinystl::vector<T> my_vector(std_vector.data(),
+                                      std_vector.data() + std_vector.size());
+         T value = n ? std_vector[n / 2] : T(0);
+         for (int k = 0; k < 2; ++k, value = static_cast<T>(1000) * scale) {
+            rtest::EQUAL(std::find(std_vector.begin(), std_vector.end(),
+                                   value) -
+                             std_vector.begin(),
+                         tinystl::find(my_vector.begin(), my_vector.end(),
+                                       value) -
+                             my_vector.begin());
+            rtest::EQUAL(
+                std::count(std_vector.begin(), std_vector.end(), value),
+                tinystl::count(my_vector.begin(), my_vector.end(), value));
+         }
+         auto std_minmax =
+             std::minmax_element(std_vector.begin(), std_vector.end());
+         auto my_minmax =
+             tinystl::minmax_element(my_vector.begin(), my_vector.end());
+         rtest::EQUAL(std_minmax.first - std_vector.begin(),
+                      my_minmax.first - my_vector.begin());
+         rtest::EQUAL(std_minmax.second - std_vector.begin(),
+                      my_minmax.second - my_vector.begin());
+         // small whole numbers, so the float sums are exact in any order
+         rtest::EQUAL(
+             std::accumulate(std_vector.begin(), std_vector.end(), T(0)),
+             tinystl::accumulate(my_vector.begin(), my_vector.end(), T(0)));
+      }
+   }
+   tinystl::__simd_isa() = detected;
+}
+
+// NaNs at both ends and in the middle: the vector kernels agree with the
+// scalar loop and stay inside the range
+template <class T>
+void check_minmax_nan() {
+   const tinystl::__simd_isa_t detected = tinystl::__simd_isa();
+   const int sizes[] = {64, SORT_TEST_SIZE};
+   for (int n : sizes) {
+      tinystl::vector<T> my_vector;
+      for (int i = 0; i < n; ++i) {
+         my_vector.push_back(
+             static_cast<T>(rtest::Tester::get_random_int(-100, 100)));
+      }
+      const T nan = std::numeric_limits<T>::quiet_NaN();
+      my_vector[0] = nan;
+      my_vector[n / 2] = nan;
+      my_vector[n - 1] = nan;
+      auto vectorized =
+          tinystl::minmax_element(my_vector.begin(), my_vector.end());
+      tinystl::__simd_isa() = tinystl::__isa_scalar;
+      auto scalar = tinystl::minmax_element(my_vector.begin(), my_vector.end());
+      tinystl::__simd_isa() = detected;
+      rtest::EQUAL(vectorized.first, scalar.first);
+      rtest::EQUAL(vectorized.second, scalar.second);
+   }
+}
+
+void algorithm_test() {
+   rtest::Tester::add_test(std::string("Radix sort int"), []() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= SORT_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100000, 100000);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      std::sort(std_vector.begin(), std_vector.end());
+      tinystl::sort(my_vector.begin(), my_vector.end());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Radix sort double"), []() {
+      std::vector<double> std_vector;
+      tinystl::vector<double> my_vector;
+      for (int i = 1; i <= SORT_TEST_SIZE; ++i) {
+         double x = rtest::Tester::get_random_int(-100000, 100000) / 7.0;
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      std::sort(std_vector.begin(), std_vector.end());
+      tinystl::sort(my_vector.begin(), my_vector.end());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Small sort"), []() {
+      tinystl::vector<unsigned char> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_vector.push_back(rtest::Tester::get_random_int(0, 255));
+      }
+      tinystl::sort(my_vector.begin(), my_vector.end());
+      rtest::EQUAL(std::is_sorted(my_vector.begin(), my_vector.end()), true);
+   });
+
+   rtest::Tester::add_test(std::string("Introsort with comparator"), []() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= SORT_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      std::sort(std_vector.begin(), std_vector.end(), std::greater<int>());
+      tinystl::sort(my_vector.begin(), my_vector.end(), std::greater<int>());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Sort by key"), []() {
+      // below and above the radix threshold, both are stable
+      const int sizes[] = {100, SORT_TEST_SIZE};
+      for (int n : sizes) {
+         std::vector<record> std_vector;
+         tinystl::vector<record> my_vector;
+         for (int i = 1; i <= n; ++i) {
+            record r = {rtest::Tester::get_random_int(-50, 50), i};
+            std_vector.push_back(r);
+            my_vector.push_back(r);
+         }
+         std::stable_sort(
+             std_vector.begin(), std_vector.end(),
+             [](const record& x, const record& y) { return x.key < y.key; });
+         tinystl::sort_by_key(my_vector.begin(), my_vector.end(),
+                              [](const record& x) { return x.key; });
+         rtest::EQUAL(std::equal(std_vector.begin(), std_vector.end(),
+                                 my_vector.begin()),
+                      true);
+      }
+   });
+
+   rtest::Tester::add_test(std::string("Sort by a non-radix key"), []() {
+      typedef std::pair<std::string, long double> item;
+      std::vector<item> std_vector;
+      tinystl::vector<item> my_vector;
+      for (int i = 1; i <= SORT_TEST_SIZE; ++i) {
+         int k = rtest::Tester::get_random_int(0, 50);
+         item x(std::to_string(k), k / 4 + 0.5L);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      // long double keys, ties keep their order
+      std::stable_sort(
+          std_vector.begin(), std_vector.end(),
+          [](const item& x, const item& y) { return x.second < y.second; });
+      tinystl::sort_by_key(my_vector.begin(), my_vector.end(),
+                           [](const item& x) { return x.second; });
+      rtest::EQUAL(std::equal(std_vector.begin(), std_vector.end(),
+                              my_vector.begin()),
+                   true);
+      // string keys
+      std::stable_sort(
+          std_vector.begin(), std_vector.end(),
+          [](const item& x, const item& y) { return x.first < y.first; });
+      tinystl::sort_by_key(my_vector.begin(), my_vector.end(),
+                           [](const item& x) { return x.first; });
+      rtest::EQUAL(std::equal(std_vector.begin(), std_vector.end(),
+                              my_vector.begin()),
+                   true);
+   });
+
+   rtest::Tester::add_test(std::string("Copy, move and fill"), []() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         std_vector.push_back(i);
+         my_vector.push_back(i);
+      }
+      // overlapping ranges in both directions
+      std::copy(std_vector.begin() + 2, std_vector.end(), std_vector.begin());
+      tinystl::copy(my_vector.begin() + 2, my_vector.end(), my_vector.begin());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      std::copy_backward(std_vector.begin(), std_vector.end() - 3,
+                         std_vector.end());
+      tinystl::copy_backward(my_vector.begin(), my_vector.end() - 3,
+                             my_vector.end());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      std::fill(std_vector.begin() + 1, std_vector.begin() + 4, -7);
+      tinystl::fill(my_vector.begin() + 1, my_vector.begin() + 4, -7);
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+
+      char buf[INIT_CONTAINER_SIZE];
+      tinystl::fill_n(buf, INIT_CONTAINER_SIZE, 'x');
+      rtest::EQUAL(std::string(buf, INIT_CONTAINER_SIZE),
+                   std::string(INIT_CONTAINER_SIZE, 'x'));
+
+      std::string from[3] = {"a", "bb", "ccc"};
+      std::string to[3];
+      tinystl::move(from, from + 3, to);
+      rtest::EQUAL(to[2], std::string("ccc"));
+   });
+
+   rtest::Tester::add_test(std::string("Find and equal"), []() {
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_vector.push_back(i);
+      rtest::EQUAL(*tinystl::find(my_vector.begin(), my_vector.end(), 7), 7);
+      rtest::EQUAL(tinystl::find(my_vector.begin(), my_vector.end(), 0) ==
+                       my_vector.end(),
+                   true);
+      const char text[] = "find the needle";
+      rtest::EQUAL(tinystl::find(text, text + sizeof(text) - 1, 'n') - text,
+                   std::ptrdiff_t(2));
+      // 'n' + 256 doesn't fit a char, memchr must not see it as 'n'
+      rtest::EQUAL(tinystl::find(text, text + sizeof(text) - 1, 'n' + 256) -
+                       text,
+                   std::ptrdiff_t(sizeof(text) - 1));
+
+      tinystl::vector<int> other(my_vector.begin(), my_vector.end());
+      rtest::EQUAL(
+          tinystl::equal(my_vector.begin(), my_vector.end(), other.begin()),
+          true);
+      other.back() = 0;
+      rtest::EQUAL(
+          tinystl::equal(my_vector.begin(), my_vector.end(), other.begin()),
+          false);
+
+      tinystl::list<int> my_list;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_list.push_back(i);
+      rtest::EQUAL(*tinystl::find(my_list.begin(), my_list.end(), 4), 4);
+   });
+
+   rtest::Tester::add_test(std::string("Lower and upper bound"), []() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-10, 10);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      std::sort(std_vector.begin(), std_vector.end());
+      tinystl::sort(my_vector.begin(), my_vector.end());
+      for (int x = -11; x <= 11; ++x) {
+         rtest::EQUAL(
+             std::lower_bound(std_vector.begin(), std_vector.end(), x) -
+                 std_vector.begin(),
+             tinystl::lower_bound(my_vector.begin(), my_vector.end(), x) -
+                 my_vector.begin());
+         rtest::EQUAL(
+             std::upper_bound(std_vector.begin(), std_vector.end(), x) -
+                 std_vector.begin(),
+             tinystl::upper_bound(my_vector.begin(), my_vector.end(), x) -
+                 my_vector.begin());
+      }
+   });
+
+   rtest::Tester::add_test(std::string("Rotate and reverse"), []() {
+      for (int k = 0; k <= INIT_CONTAINER_SIZE; ++k) {
+         std::vector<int> std_vector;
+         tinystl::vector<int> my_vector;
+         tinystl::list<int> my_list;
+         for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+            std_vector.push_back(i);
+            my_vector.push_back(i);
+            my_list.push_back(i);
+         }
+         std::rotate(std_vector.begin(), std_vector.begin() + k,
+                     std_vector.end());
+         int* p = tinystl::rotate(my_vector.begin(), my_vector.begin() + k,
+                                  my_vector.end());
+         rtest::CONTAINER_EQUAL(std_vector, my_vector);
+         rtest::EQUAL(*p == 1 || k == 0, true);
+
+         // the list relinks, first still refers to 1
+         tinystl::list<int>::iterator middle = my_list.begin();
+         for (int i = 0; i < k; ++i) ++middle;
+         tinystl::rotate(my_list.begin(), middle, my_list.end());
+         rtest::CONTAINER_EQUAL(std_vector, my_list);
+
+         std::reverse(std_vector.begin(), std_vector.begin() + k);
+         tinystl::reverse(my_vector.begin(), my_vector.begin() + k);
+         rtest::CONTAINER_EQUAL(std_vector, my_vector);
+         std::reverse(std_vector.begin(), std_vector.begin() + k);
+         std::reverse(std_vector.begin(), std_vector.end());
+         tinystl::reverse(my_list.begin(), my_list.end());
+         rtest::CONTAINER_EQUAL(std_vector, my_list);
+      }
+   });
+
+   rtest::Tester::add_test(std::string("Vector of strings"), []() {
+      std::vector<std::string> std_vector;
+      tinystl::vector<std::string> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         std::string s(i, static_cast<char>('a' + i));
+         std_vector.push_back(s);
+         my_vector.push_back(s);
+      }
+      std_vector.insert(std_vector.begin() + 3, 2, std::string("x"));
+      my_vector.insert(my_vector.begin() + 3, 2, std::string("x"));
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      std_vector.erase(std_vector.begin() + 1, std_vector.begin() + 4);
+      my_vector.erase(my_vector.begin() + 1, my_vector.begin() + 4);
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Vectorized scans"), []() {
+      check_scans<int>(1);
+      check_scans<unsigned>(1);
+      check_scans<long long>(1LL << 40);
+      check_scans<unsigned long long>(1);
+      check_scans<float>(1);
+      check_scans<double>(0.5);
+      check_minmax_nan<float>();
+      check_minmax_nan<double>();
+      // mixed types take the scalar loops
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_vector.push_back(i);
+      rtest::EQUAL(tinystl::contains(my_vector.begin(), my_vector.end(), 2.5),
+                   false);
+      rtest::EQUAL(tinystl::contains(my_vector.begin(), my_vector.end(), 3.0),
+                   true);
+      rtest::EQUAL(tinystl::any_of(my_vector.begin(), my_vector.end(),
+                                   [](int x) { return x > 9; }),
+                   true);
+      rtest::EQUAL(tinystl::accumulate(my_vector.begin(), my_vector.end(),
+                                       0LL),
+                   55LL);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -0,0 +1,75 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "alloc.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+void alloc_test() {
+   rtest::Tester::add_test(std::string("Size class lookup"), []() {
+      typedef tinystl::__default_size_classes classes;
+      rtest::EQUAL(classes::round_up(1), size_t(8));
+      rtest::EQUAL(classes::round_up(64), size_t(64));
+      rtest::EQUAL(classes::round_up(65), size_t(80));
+      rtest::EQUAL(classes::round_up(100), size_t(112));
+      rtest::EQUAL(classes::round_up(128), size_t(128));
+      rtest::EQUAL(classes::index(72), classes::index(80));
+
+      typedef tinystl::size_classes<16, 48, 256> sparse;
+      static_assert(sparse::round_up(17) == 48, "lookup is constexpr");
+      rtest::EQUAL(sparse::round_up(1), size_t(16));
+      rtest::EQUAL(sparse::round_up(49), size_t(256));
+      rtest::EQUAL(sparse::max_bytes, size_t(256));
+   });
+
+   rtest::Tester::add_test(std::string("Custom layout round trip"), []() {
+      typedef tinystl::__default_alloc_template<
+          false, 1, tinystl::size_classes<16, 48, 256>>
+          pool;
+      std::vector<char*> blocks;
+      std::vector<size_t> sizes;
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 100; ++i) {
+         size_t n = 1 + static_cast<size_t>(i * 37) % 300;
+         char* p = static_cast<char*>(pool::allocate(n));
+         std::memset(p, i & 0x7f, n);
+         blocks.push_back(p);
+         sizes.push_back(n);
+      }
+      bool intact = true;
+      for (size_t i = 0; i < blocks.size(); ++i) {
+         for (size_t k = 0; k < sizes[i]; ++k) {
+            intact = intact && blocks[i][k] == static_cast<char>(i & 0x7f);
+         }
+         pool::deallocate(blocks[i], sizes[i]);
+      }
+      rtest::EQUAL(intact, true);
+      // freed blocks are handed out again
+      void* p = pool::allocate(40);
+      void* q = pool::allocate(40);
+      rtest::EQUAL(p != q, true);
+      pool::deallocate(p, 40);
+      pool::deallocate(q, 40);
+   });
+
+   rtest::Tester::add_test(std::string("Refill batches adapt"), []() {
+      typedef tinystl::__default_alloc_template<false, 2> pool;
+      // a cold class refills once
+      std::vector<void*> cold;
+      for (int i = 0; i < 20; ++i) cold.push_back(pool::allocate(128));
+      rtest::EQUAL(pool::refill_batch_size(128), 20);
+      // a hot class keeps running dry, its batches grow
+      std::vector<void*> hot;
+      for (int i = 0; i < 40000; ++i) hot.push_back(pool::allocate(8));
+      rtest::EQUAL(pool::refill_batch_size(8) > 20, true);
+      // the cold class waited through many refills, its batch shrinks
+      cold.push_back(pool::allocate(128));
+      rtest::EQUAL(pool::refill_batch_size(128) < 20, true);
+      for (size_t i = 0; i < hot.size(); ++i) pool::deallocate(hot[i], 8);
+      for (size_t i = 0; i < cold.size(); ++i) pool::deallocate(cold[i], 128);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
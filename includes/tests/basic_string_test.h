@@ -0,0 +1,102 @@
+#include <string>
+#include <type_traits>
+
+#include "basic_string.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define STRING_TEST_SIZE 1000
+void basic_string_test() {
+   rtest::Tester::add_test(std::string("Short strings stay inline"), []() {
+      tinystl::string my_string("short key");
+      rtest::EQUAL(my_string.size(), size_t(9));
+      const size_t inline_capacity = tinystl::string::small_capacity;
+      rtest::EQUAL(my_string.capacity(), inline_capacity);
+      std::string full(inline_capacity, 'x');
+      tinystl::string my_full(full.c_str());
+      rtest::EQUAL(std::string(my_full.c_str()), full);
+      rtest::EQUAL(my_full.capacity(), inline_capacity);
+      my_full.push_back('y');
+      rtest::EQUAL(my_full.size(), full.size() + 1);
+      rtest::EQUAL(my_full.capacity() > full.size(), true);
+      rtest::EQUAL(std::string(my_full.c_str()), full + "y");
+   });
+
+   rtest::Tester::add_test(std::string("Append and resize"), []() {
+      std::string std_string;
+      tinystl::string my_string;
+      for (int i = 1; i <= STRING_TEST_SIZE; ++i) {
+         int op = rtest::Tester::get_random_int(0, 9);
+         if (op == 0 && !std_string.empty()) {
+            std_string.pop_back();
+            my_string.pop_back();
+         } else if (op == 1) {
+            size_t n = rtest::Tester::get_random_int(0, 40);
+            std_string.resize(n, 'r');
+            my_string.resize(n, 'r');
+         } else if (op == 2) {
+            // append a piece of itself
+            size_t n = std_string.size() / 2;
+            std_string.append(std_string.data(), n);
+            my_string.append(my_string.data(), n);
+         } else {
+            int c = rtest::Tester::get_random_int('a', 'z');
+            std_string.push_back(static_cast<char>(c));
+            my_string += static_cast<char>(c);
+         }
+      }
+      rtest::EQUAL(my_string.size(), std_string.size());
+      rtest::EQUAL(std::string(my_string.c_str()), std_string);
+      rtest::CONTAINER_EQUAL(std_string, my_string);
+   });
+
+   rtest::Tester::add_test(std::string("Copy, move and assign"), []() {
+      tinystl::string a("a string that does not fit inline");
+      tinystl::string b(a), c("short");
+      rtest::EQUAL(b == a, true);
+      c = a;
+      rtest::EQUAL(c, a);
+      tinystl::string d(std::move(b));
+      rtest::EQUAL(d, a);
+      rtest::EQUAL(b.empty(), true);
+      c = "short again";
+      rtest::EQUAL(c == "short again", true);
+      d = std::move(c);
+      rtest::EQUAL(d == "short again", true);
+      rtest::EQUAL(a + d, tinystl::string("a string that does not fit "
+                                          "inlineshort again"));
+      rtest::EQUAL(a.substr(2, 6), tinystl::string("string"));
+      rtest::EQUAL(tinystl::string("abc") < tinystl::string("abd"), true);
+      // std::vector moves rather than copies on reallocation
+      rtest::EQUAL(std::is_nothrow_move_constructible<tinystl::string>::value,
+                   true);
+      rtest::EQUAL(std::is_nothrow_move_assignable<tinystl::string>::value,
+                   true);
+   });
+
+   rtest::Tester::add_test(std::string("Find"), []() {
+      std::string std_string;
+      for (int i = 1; i <= STRING_TEST_SIZE; ++i) {
+         int c = rtest::Tester::get_random_int('a', 'd');
+         std_string.push_back(static_cast<char>(c));
+      }
+      tinystl::string my_string(std_string.c_str());
+      bool same = true;
+      const char* needles[] = {"a", "abc", "dddd", "bad", "", "abcdabcd"};
+      for (const char* needle : needles) {
+         for (size_t pos = 0; pos <= std_string.size(); pos += 37) {
+            same = same && my_string.find(needle, pos) ==
+                               std_string.find(needle, pos);
+         }
+      }
+      for (char c = 'a'; c <= 'e'; ++c) {
+         same = same && my_string.find(c, 5) == std_string.find(c, 5);
+         same = same && my_string.rfind(c) == std_string.rfind(c);
+      }
+      rtest::EQUAL(same, true);
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
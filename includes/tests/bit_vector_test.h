@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+
+#include "bit_vector.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define BIT_TEST_SIZE 1000
+void bit_vector_test() {
+   rtest::Tester::add_test(std::string("Push back and index"), []() {
+      std::vector<bool> std_vector;
+      tinystl::bit_vector my_vector;
+      for (int i = 1; i <= BIT_TEST_SIZE; ++i) {
+         bool x = rtest::Tester::get_random_int(0, 1) == 1;
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      my_vector[3] = !my_vector[3];
+      std_vector[3] = !std_vector[3];
+      my_vector.pop_back();
+      std_vector.pop_back();
+      rtest::EQUAL(my_vector.size(), std_vector.size());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Resize"), []() {
+      std::vector<bool> std_vector(INIT_CONTAINER_SIZE, false);
+      tinystl::bit_vector my_vector(INIT_CONTAINER_SIZE);
+      std_vector.resize(BIT_TEST_SIZE, true);
+      my_vector.resize(BIT_TEST_SIZE, true);
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      std_vector.resize(INIT_CONTAINER_SIZE * 7);
+      my_vector.resize(INIT_CONTAINER_SIZE * 7);
+      std_vector.resize(BIT_TEST_SIZE, false);
+      my_vector.resize(BIT_TEST_SIZE, false);
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      rtest::EQUAL(my_vector.count(), size_t(INIT_CONTAINER_SIZE * 6));
+   });
+
+   rtest::Tester::add_test(std::string("Count and find"), []() {
+      std::vector<size_t> std_set;
+      tinystl::bit_vector my_vector(BIT_TEST_SIZE);
+      rtest::EQUAL(my_vector.find_first(), my_vector.size());
+      for (size_t i = 0; i < BIT_TEST_SIZE; ++i) {
+         if (rtest::Tester::get_random_int(0, 9) == 0) {
+            std_set.push_back(i);
+            my_vector[i] = true;
+         }
+      }
+      std::vector<size_t> my_set;
+      for (size_t i = my_vector.find_first(); i < my_vector.size();
+           i = my_vector.find_next(i)) {
+         my_set.push_back(i);
+      }
+      rtest::EQUAL(my_vector.count(), std_set.size());
+      rtest::CONTAINER_EQUAL(std_set, my_set);
+   });
+
+   rtest::Tester::add_test(std::string("Bitwise operators"), []() {
+      tinystl::bit_vector a(BIT_TEST_SIZE), b(BIT_TEST_SIZE);
+      std::vector<bool> std_and, std_or, std_xor;
+      for (size_t i = 0; i < BIT_TEST_SIZE; ++i) {
+         bool x = rtest::Tester::get_random_int(0, 1) == 1;
+         bool y = rtest::Tester::get_random_int(0, 1) == 1;
+         a[i] = x;
+         b[i] = y;
+         std_and.push_back(x && y);
+         std_or.push_back(x || y);
+         std_xor.push_back(x != y);
+      }
+      tinystl::bit_vector c(BIT_TEST_SIZE), d(BIT_TEST_SIZE);
+      c |= a;
+      d |= a;
+      a &= b;
+      c |= b;
+      d ^= b;
+      rtest::CONTAINER_EQUAL(std_and, a);
+      rtest::CONTAINER_EQUAL(std_or, c);
+      rtest::CONTAINER_EQUAL(std_xor, d);
+      d.flip();
+      d.flip();
+      rtest::CONTAINER_EQUAL(std_xor, d);
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
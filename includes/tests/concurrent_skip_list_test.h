@@ -0,0 +1,177 @@
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_skip_list.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SKIP_LIST_TEST_SIZE 10000
+#define SKIP_LIST_TEST_THREADS 4
+void concurrent_skip_list_test() {
+   rtest::Tester::add_test(std::string("Insert, find and erase"), []() {
+      std::map<int, int> std_map;
+      tinystl::concurrent_skip_list<int, int> my_list;
+      bool same = true;
+      for (int i = 0; i < SKIP_LIST_TEST_SIZE; ++i) {
+         int key = rtest::Tester::get_random_int(0, SKIP_LIST_TEST_SIZE / 10);
+         int op = rtest::Tester::get_random_int(0, 2);
+         if (op == 0) {
+            bool inserted = std_map.insert(std::make_pair(key, i)).second;
+            same = same && my_list.insert(key, i) == inserted;
+         } else if (op == 1) {
+            bool erased = std_map.erase(key) == 1;
+            same = same && my_list.erase(key) == erased;
+         } else {
+            int value = -1;
+            bool found = my_list.find(key, value);
+            std::map<int, int>::iterator it = std_map.find(key);
+            same = same && found == (it != std_map.end()) &&
+                   (!found || value == it->second);
+         }
+      }
+      rtest::EQUAL(same, true);
+      rtest::EQUAL(my_list.size(), std_map.size());
+
+      std::vector<int> expected, result;
+      for (std::map<int, int>::iterator it = std_map.begin();
+           it != std_map.end(); ++it) {
+         expected.push_back(it->first);
+      }
+      tinystl::concurrent_skip_list<int, int>::snapshot snapshot(my_list);
+      for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+         result.push_back(it->first);
+      }
+      rtest::CONTAINER_EQUAL(expected, result);
+   });
+
+   rtest::Tester::add_test(std::string("Snapshots keep their view"), []() {
+      tinystl::concurrent_skip_list<std::string, int> my_list;
+      for (int i = 0; i < INIT_CONTAINER_SIZE; ++i) {
+         my_list.insert(std::to_string(i), i);
+      }
+      std::vector<std::string> before, after;
+      {
+         tinystl::concurrent_skip_list<std::string, int>::snapshot snapshot(
+             my_list);
+         my_list.erase("3");
+         my_list.erase("5");
+         my_list.insert("3", 33);
+         my_list.insert("55", 55);
+         for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+            before.push_back(it->first);
+         }
+         auto it = snapshot.lower_bound("3");
+         rtest::EQUAL(it->second, 3);
+         rtest::EQUAL((++it)->first, std::string("4"));
+         rtest::EQUAL((++it)->first, std::string("5"));
+      }
+      tinystl::concurrent_skip_list<std::string, int>::snapshot snapshot(
+          my_list);
+      for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+         after.push_back(it->first);
+      }
+      std::vector<std::string> expected_before = {"0", "1", "2", "3", "4",
+                                                  "5", "6", "7", "8", "9"};
+      std::vector<std::string> expected_after = {"0", "1", "2", "3", "4",
+                                                 "55", "6", "7", "8", "9"};
+      rtest::CONTAINER_EQUAL(expected_before, before);
+      rtest::CONTAINER_EQUAL(expected_after, after);
+      int value = 0;
+      rtest::EQUAL(my_list.find("3", value), true);
+      rtest::EQUAL(value, 33);
+      rtest::EQUAL(my_list.contains("5"), false);
+      my_list.purge();
+      rtest::EQUAL(my_list.size(), size_t(INIT_CONTAINER_SIZE));
+   });
+
+   rtest::Tester::add_test(std::string("Writes from many threads"), []() {
+      tinystl::concurrent_skip_list<int, int> my_list;
+      std::atomic<int> inserted(0);
+      std::vector<std::thread> threads;
+      // every thread tries every key, each key goes in once
+      for (int t = 0; t < SKIP_LIST_TEST_THREADS; ++t) {
+         threads.push_back(std::thread([&my_list, &inserted, t]() {
+            for (int i = 0; i < SKIP_LIST_TEST_SIZE; ++i) {
+               int key = (i * 7 + t * 13) % SKIP_LIST_TEST_SIZE;
+               if (my_list.insert(key, t)) ++inserted;
+            }
+         }));
+      }
+      for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+      threads.clear();
+      // then each drops its share of the odd keys
+      for (int t = 0; t < SKIP_LIST_TEST_THREADS; ++t) {
+         threads.push_back(std::thread([&my_list, t]() {
+            for (int key = 2 * t + 1; key < SKIP_LIST_TEST_SIZE;
+                 key += 2 * SKIP_LIST_TEST_THREADS) {
+               my_list.erase(key);
+            }
+         }));
+      }
+      for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+      rtest::EQUAL(inserted.load(), SKIP_LIST_TEST_SIZE);
+      rtest::EQUAL(my_list.size(), size_t(SKIP_LIST_TEST_SIZE / 2));
+
+      bool all_even = true;
+      int n = 0, previous = -1;
+      tinystl::concurrent_skip_list<int, int>::snapshot snapshot(my_list);
+      for (auto it = snapshot.begin(); it != snapshot.end(); ++it, ++n) {
+         all_even = all_even && it->first % 2 == 0 && it->first > previous;
+         previous = it->first;
+      }
+      rtest::EQUAL(all_even, true);
+      rtest::EQUAL(n, SKIP_LIST_TEST_SIZE / 2);
+   });
+
+   rtest::Tester::add_test(std::string("Scans during writes"), []() {
+      tinystl::concurrent_skip_list<int, int> my_list;
+      // the odd key of a pair (2k, 2k + 1) is inserted after and erased
+      // before the even one, so no consistent view has it alone
+      std::atomic<bool> done(false);
+      std::vector<std::thread> writers;
+      for (int t = 0; t < SKIP_LIST_TEST_THREADS - 1; ++t) {
+         writers.push_back(std::thread([&my_list, t]() {
+            for (int round = 0; round < INIT_CONTAINER_SIZE * 5; ++round) {
+               for (int k = t; k < SKIP_LIST_TEST_SIZE / 20; k += 3) {
+                  my_list.insert(2 * k, round);
+                  my_list.insert(2 * k + 1, round);
+               }
+               for (int k = t; k < SKIP_LIST_TEST_SIZE / 20; k += 3) {
+                  my_list.erase(2 * k + 1);
+                  my_list.erase(2 * k);
+               }
+            }
+         }));
+      }
+      bool sorted = true, no_orphans = true;
+      int scans = 0;
+      std::thread reader([&]() {
+         while (!done.load()) {
+            tinystl::concurrent_skip_list<int, int>::snapshot snapshot(
+                my_list);
+            int previous = -1;
+            for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+               sorted = sorted && it->first > previous;
+               no_orphans = no_orphans &&
+                            (it->first % 2 == 0 || previous == it->first - 1);
+               previous = it->first;
+            }
+            ++scans;
+         }
+      });
+      for (size_t t = 0; t < writers.size(); ++t) writers[t].join();
+      done.store(true);
+      reader.join();
+      rtest::EQUAL(sorted, true);
+      rtest::EQUAL(no_orphans, true);
+      rtest::EQUAL(scans > 0, true);
+      rtest::EQUAL(my_list.empty(), true);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define CONCURRENT_TEST_SIZE 10000
+#define CONCURRENT_TEST_THREADS 4
+void concurrent_vector_test() {
+   rtest::Tester::add_test(std::string("Push back and index"), []() {
+      std::vector<int> std_vector;
+      tinystl::concurrent_vector<int> my_vector;
+      for (int i = 1; i <= CONCURRENT_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      rtest::EQUAL(my_vector[CONCURRENT_TEST_SIZE / 2],
+                   std_vector[CONCURRENT_TEST_SIZE / 2]);
+      rtest::EQUAL(my_vector.back(), std_vector.back());
+      rtest::EQUAL(my_vector.capacity() >= my_vector.size(), true);
+   });
+
+   rtest::Tester::add_test(std::string("References never move"), []() {
+      tinystl::concurrent_vector<std::string> my_vector;
+      my_vector.push_back(std::string("first"));
+      std::string* first = &my_vector[0];
+      for (int i = 1; i <= CONCURRENT_TEST_SIZE; ++i) {
+         my_vector.push_back(std::to_string(i));
+      }
+      rtest::EQUAL(first == &my_vector[0], true);
+      rtest::EQUAL(*first, std::string("first"));
+      rtest::EQUAL(my_vector[CONCURRENT_TEST_SIZE],
+                   std::to_string(CONCURRENT_TEST_SIZE));
+   });
+
+   rtest::Tester::add_test(std::string("Grow by and reserve"), []() {
+      tinystl::concurrent_vector<int> my_vector;
+      my_vector.reserve(100);
+      rtest::EQUAL(my_vector.capacity() >= size_t(100), true);
+      my_vector.push_back(1);
+      // crosses several segments
+      tinystl::concurrent_vector<int>::iterator it =
+          my_vector.grow_by(INIT_CONTAINER_SIZE * 10, 7);
+      rtest::EQUAL(it - my_vector.begin(), std::ptrdiff_t(1));
+      rtest::EQUAL(my_vector.size(), size_t(INIT_CONTAINER_SIZE * 10 + 1));
+      size_t sevens = 0;
+      for (size_t i = 0; i < my_vector.size(); ++i) sevens += my_vector[i] == 7;
+      rtest::EQUAL(sevens, size_t(INIT_CONTAINER_SIZE * 10));
+      my_vector.clear();
+      rtest::EQUAL(my_vector.empty(), true);
+      my_vector.push_back(2);
+      rtest::EQUAL(my_vector.front(), 2);
+   });
+
+   rtest::Tester::add_test(std::string("Push back from many threads"), []() {
+      tinystl::concurrent_vector<int> my_vector;
+      std::vector<std::thread> threads;
+      for (int t = 0; t < CONCURRENT_TEST_THREADS; ++t) {
+         threads.push_back(std::thread([&my_vector, t]() {
+            for (int i = 0; i < CONCURRENT_TEST_SIZE; ++i) {
+               if (i % 100 == 0) {
+                  my_vector.grow_by(10, -1);
+               } else {
+                  my_vector.push_back(t * CONCURRENT_TEST_SIZE + i);
+               }
+            }
+         }));
+      }
+      for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+      std::vector<int> expected, result;
+      for (size_t i = 0; i < my_vector.size(); ++i) {
+         result.push_back(my_vector[i]);
+      }
+      for (int t = 0; t < CONCURRENT_TEST_THREADS; ++t) {
+         for (int i = 0; i < CONCURRENT_TEST_SIZE; ++i) {
+            if (i % 100 == 0) {
+               expected.insert(expected.end(), 10, -1);
+            } else {
+               expected.push_back(t * CONCURRENT_TEST_SIZE + i);
+            }
+         }
+      }
+      std::sort(expected.begin(), expected.end());
+      std::sort(result.begin(), result.end());
+      rtest::CONTAINER_EQUAL(expected, result);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
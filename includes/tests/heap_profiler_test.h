@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "heap_profiler.h"
+#include "list.h"
+#include "rtest.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+void heap_profiler_test() {
+   rtest::Tester::add_test(std::string("Live heap"), []() {
+      // sample (nearly) every allocation
+      tinystl::heap_profiler::start(1);
+      tinystl::list<int>* my_list = new tinystl::list<int>;
+      for (int i = 1; i <= 1000; ++i) my_list->push_back(i);
+      size_t with_list = tinystl::heap_profiler::live_bytes();
+      rtest::EQUAL(with_list > 1000 * sizeof(int), true);
+
+      my_list->clear();
+      delete my_list;
+      rtest::EQUAL(tinystl::heap_profiler::live_bytes() < with_list, true);
+      tinystl::heap_profiler::stop();
+   });
+
+   rtest::Tester::add_test(std::string("Dump"), []() {
+      tinystl::heap_profiler::start(1);
+      tinystl::vector<double> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_vector.push_back(i);
+      tinystl::heap_profiler::stop();
+
+      std::string path = "heap_profile_test.txt";
+      rtest::EQUAL(tinystl::heap_profiler::dump(
+                       path.c_str(), tinystl::heap_profiler::text),
+                   true);
+      std::ifstream in(path);
+      std::string content((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+      rtest::EQUAL(content.find("double") != std::string::npos, true);
+      std::remove(path.c_str());
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -0,0 +1,123 @@
+#include <string>
+
+#include "instrument.h"
+#include "list.h"
+#include "rtest.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+// copyable only, counts its own copies, which don't throw
+struct payload {
+   int value;
+   payload(int v = 0) : value(v) {}
+   payload(const payload& x) noexcept : value(x.value) { ++copies(); }
+   payload& operator=(const payload& x) noexcept {
+      value = x.value;
+      ++copies();
+      return *this;
+   }
+   ~payload() {}
+   bool operator<(const payload& x) const { return value < x.value; }
+   static size_t& copies() {
+      static size_t n = 0;
+      return n;
+   }
+};
+
+// movable, counts its own moves, which may throw
+struct movable_payload {
+   int value;
+   movable_payload(int v = 0) : value(v) {}
+   movable_payload(const movable_payload& x) : value(x.value) {}
+   movable_payload(movable_payload&& x) : value(x.value) { ++moves(); }
+   movable_payload& operator=(const movable_payload& x) {
+      value = x.value;
+      return *this;
+   }
+   movable_payload& operator=(movable_payload&& x) {
+      value = x.value;
+      ++moves();
+      return *this;
+   }
+   bool operator<(const movable_payload& x) const { return value < x.value; }
+   static size_t& moves() {
+      static size_t n = 0;
+      return n;
+   }
+};
+
+void instrument_test() {
+#ifndef __INSTRUMENT_OPS
+   std::cout << "define __INSTRUMENT_OPS to run the instrumentation tests\n";
+#else
+   rtest::Tester::add_test(std::string("Vector growth"), []() {
+      tinystl::op_counter::reset();
+      {
+         tinystl::vector<payload> my_vector;
+         for (int i = 1; i <= 4; ++i) my_vector.push_back(payload(i));
+      }
+      // 1, 2, 4: the old elements are copied on every reallocation
+      tinystl::op_counts growth =
+          tinystl::op_counter::for_op("vector::insert_aux");
+      rtest::EQUAL(growth.copies, static_cast<size_t>(3 + 0 + 1 + 2));
+      tinystl::op_counts total = tinystl::op_counter::for_type<payload>();
+      rtest::EQUAL(total.copies, static_cast<size_t>(4 + 3));
+      rtest::EQUAL(total.destructions, total.copies);
+   });
+
+   rtest::Tester::add_test(std::string("POD fills count copies"), []() {
+      int raw[INIT_CONTAINER_SIZE];
+      tinystl::op_counter::reset();
+      tinystl::uninitialized_fill(raw, raw + INIT_CONTAINER_SIZE, 7);
+      tinystl::uninitialized_fill_n(raw, INIT_CONTAINER_SIZE, 7);
+      rtest::EQUAL(tinystl::op_counter::for_type<int>().copies,
+                   static_cast<size_t>(2 * INIT_CONTAINER_SIZE));
+   });
+
+   rtest::Tester::add_test(std::string("List merge relinks"), []() {
+      tinystl::list<payload> one_list;
+      tinystl::list<payload> two_list;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         one_list.push_back(payload(2 * i));
+         two_list.push_back(payload(2 * i + 1));
+      }
+      tinystl::op_counter::reset();
+      one_list.merge(two_list);
+      tinystl::op_counts merge = tinystl::op_counter::for_op("list::merge");
+      rtest::EQUAL(merge.copies + merge.moves, static_cast<size_t>(0));
+   });
+
+   rtest::Tester::add_test(std::string("List sort copies payloads"), []() {
+      tinystl::list<payload> my_list;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_list.push_back(payload(rtest::Tester::get_random_int(-10, 10)));
+      }
+      tinystl::op_counter::reset();
+      payload::copies() = 0;
+      my_list.sort(my_list.begin(), my_list.end());
+      tinystl::op_counts sort = tinystl::op_counter::for_op("list::sort");
+      // without move operations every swap copies
+      rtest::EQUAL(sort.copies, payload::copies());
+      rtest::EQUAL(sort.moves, static_cast<size_t>(0));
+      tinystl::op_counter::report(std::cout);
+   });
+
+   rtest::Tester::add_test(std::string("List sort moves payloads"), []() {
+      tinystl::list<movable_payload> my_list;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_list.push_back(
+             movable_payload(rtest::Tester::get_random_int(-10, 10)));
+      }
+      tinystl::op_counter::reset();
+      movable_payload::moves() = 0;
+      my_list.sort(my_list.begin(), my_list.end());
+      tinystl::op_counts sort = tinystl::op_counter::for_op("list::sort");
+      rtest::EQUAL(sort.moves, movable_payload::moves());
+      rtest::EQUAL(sort.copies, static_cast<size_t>(0));
+   });
+   rtest::Tester::run();
+#endif
+}
+
+}  // namespace test
@@ -1,6 +1,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include "list.h"
 #include "rtest.h"
@@ -88,6 +89,90 @@ void list_test() {
       one_list.unique();
       one_list._traversal();
    });
+
+   rtest::Tester::add_test(std::string("Bulk construct and insert"), []() {
+      int values[INIT_CONTAINER_SIZE];
+      for (int i = 0; i < INIT_CONTAINER_SIZE; ++i) values[i] = i;
+      tinystl::list<int> my_list(values, values + INIT_CONTAINER_SIZE);
+      std::list<int> std_list(values, values + INIT_CONTAINER_SIZE);
+      rtest::CONTAINER_EQUAL(std_list, my_list);
+
+      tinystl::list<int>::iterator pos = my_list.begin();
+      ++(++pos);
+      my_list.insert(pos, 3, 7);
+      my_list.insert(my_list.end(), size_t(2), -1);
+      my_list.insert(my_list.begin(), values + 5, values + 8);
+      std::list<int>::iterator std_pos = std_list.begin();
+      ++(++std_pos);
+      std_list.insert(std_pos, 3, 7);
+      std_list.insert(std_list.end(), size_t(2), -1);
+      std_list.insert(std_list.begin(), values + 5, values + 8);
+      rtest::CONTAINER_EQUAL(std_list, my_list);
+
+      tinystl::list<std::string> filled(size_t(INIT_CONTAINER_SIZE), "x");
+      tinystl::list<std::string> copied(filled.begin(), filled.end());
+      copied.insert(copied.begin(), filled.begin(), filled.begin());
+      rtest::EQUAL(copied.size(), size_t(INIT_CONTAINER_SIZE));
+      rtest::EQUAL(copied.back(), std::string("x"));
+      rtest::EQUAL(tinystl::list<int>(5, 5).size(), size_t(5));
+   });
+
+   rtest::Tester::add_test(std::string("Compact after churn"), []() {
+      typedef tinystl::list<int>::iterator iterator;
+      tinystl::list<int> my_list;
+      std::vector<iterator> nodes;
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 100; ++i) {
+         my_list.push_back(i);
+         nodes.push_back(--my_list.end());
+      }
+      // splice the nodes to the back in a random order
+      for (size_t i = nodes.size() - 1; i > 0; --i) {
+         size_t j = static_cast<size_t>(
+             rtest::Tester::get_random_int(0, static_cast<int>(i)));
+         std::swap(nodes[i], nodes[j]);
+      }
+      for (size_t i = 0; i < nodes.size(); ++i) {
+         my_list.splice(my_list.end(), nodes[i]);
+      }
+      std::list<int> before;
+      for (iterator it = my_list.begin(); it != my_list.end(); ++it) {
+         before.push_back(*it);
+      }
+
+      my_list.compact();
+      rtest::CONTAINER_EQUAL(before, my_list);
+      bool ascending = true;
+      for (iterator it = my_list.begin(); it.node->next != my_list.end().node;
+           ++it) {
+         ascending = ascending && it.node < it.node->next;
+      }
+      rtest::EQUAL(ascending, true);
+
+      // relink keeps the elements but takes the address order
+      nodes.clear();
+      for (iterator it = my_list.begin(); it != my_list.end(); ++it) {
+         nodes.push_back(it);
+      }
+      for (size_t i = 0; i + 1 < nodes.size(); i += 2) {
+         my_list.splice(my_list.begin(), nodes[i + 1]);
+      }
+      my_list.relink_by_address();
+      ascending = true;
+      for (iterator it = my_list.begin(); it.node->next != my_list.end().node;
+           ++it) {
+         ascending = ascending && it.node < it.node->next;
+      }
+      rtest::EQUAL(ascending, true);
+      rtest::EQUAL(my_list.size(), before.size());
+
+      long long sum = 0, expected = 0;
+      my_list.for_each([&sum](int x) { sum += x; });
+      for (std::list<int>::iterator it = before.begin(); it != before.end();
+           ++it) {
+         expected += *it;
+      }
+      rtest::EQUAL(sum, expected);
+   });
    rtest::Tester::run();
 }
 
@@ -0,0 +1,119 @@
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "lru_cache.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define LRU_TEST_SIZE 10000
+void lru_cache_test() {
+   rtest::Tester::add_test(std::string("Get, put and eviction order"), []() {
+      tinystl::lru_cache<int, std::string> cache(3);
+      cache.put(1, "one");
+      cache.put(2, "two");
+      cache.put(3, "three");
+      rtest::EQUAL(*cache.get(1), std::string("one"));
+      // 2 is now the least recently used
+      cache.put(4, "four");
+      rtest::EQUAL(cache.contains(2), false);
+      rtest::EQUAL(cache.contains(1), true);
+      rtest::EQUAL(cache.size(), size_t(3));
+      cache.put(3, "THREE");
+      cache.put(5, "five");
+      rtest::EQUAL(cache.contains(1), false);
+      rtest::EQUAL(*cache.peek(3), std::string("THREE"));
+      rtest::EQUAL(cache.get(2) == 0, true);
+      rtest::EQUAL(cache.hits(), size_t(1));
+      rtest::EQUAL(cache.misses(), size_t(1));
+      rtest::EQUAL(cache.evictions(), size_t(2));
+      rtest::EQUAL(cache.erase(4), true);
+      rtest::EQUAL(cache.erase(4), false);
+      rtest::EQUAL(cache.size(), size_t(2));
+   });
+
+   rtest::Tester::add_test(std::string("Same as list and map"), []() {
+      // the hand-written cache this replaces
+      std::list<std::pair<int, int>> order;
+      std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+      tinystl::lru_cache<int, int> cache(INIT_CONTAINER_SIZE * 10);
+      size_t hits = 0;
+      bool same = true;
+      for (int i = 0; i < LRU_TEST_SIZE; ++i) {
+         int key = rtest::Tester::get_random_int(0, INIT_CONTAINER_SIZE * 20);
+         std::unordered_map<int,
+                            std::list<std::pair<int, int>>::iterator>::iterator
+             it = index.find(key);
+         int* value = cache.get(key);
+         if (it != index.end()) {
+            ++hits;
+            order.splice(order.begin(), order, it->second);
+            same = same && value && *value == it->second->second;
+         } else {
+            same = same && value == 0;
+            order.push_front(std::make_pair(key, i));
+            index[key] = order.begin();
+            if (order.size() > size_t(INIT_CONTAINER_SIZE * 10)) {
+               index.erase(order.back().first);
+               order.pop_back();
+            }
+            cache.put(key, i);
+         }
+      }
+      rtest::EQUAL(same, true);
+      rtest::EQUAL(cache.hits(), hits);
+      rtest::EQUAL(cache.size(), order.size());
+   });
+
+   rtest::Tester::add_test(std::string("Byte budget and batches"), []() {
+      tinystl::lru_cache<std::string, std::string> cache(LRU_TEST_SIZE, 100);
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 2; ++i) {
+         cache.put(std::to_string(i), std::string(10, 'x'), 10);
+      }
+      rtest::EQUAL(cache.size(), size_t(10));
+      rtest::EQUAL(cache.bytes(), size_t(100));
+      rtest::EQUAL(cache.contains(std::to_string(9)), false);
+      rtest::EQUAL(cache.contains(std::to_string(10)), true);
+
+      cache.put(std::to_string(19), std::string(50, 'x'), 50);
+      rtest::EQUAL(cache.bytes() <= size_t(100), true);
+      rtest::EQUAL(cache.contains(std::to_string(19)), true);
+
+      cache.evict(2);
+      rtest::EQUAL(cache.bytes(), size_t(80));
+      cache.resize(2);
+      rtest::EQUAL(cache.size(), size_t(2));
+      cache.clear();
+      rtest::EQUAL(cache.empty(), true);
+      rtest::EQUAL(cache.bytes(), size_t(0));
+   });
+
+   rtest::Tester::add_test(std::string("Segmented LRU resists scans"), []() {
+      tinystl::lru_cache<int, int, std::hash<int>, tinystl::slru_policy> slru(
+          INIT_CONTAINER_SIZE * 10);
+      tinystl::lru_cache<int, int> lru(INIT_CONTAINER_SIZE * 10);
+      // a hot set used twice, then one long scan
+      for (int round = 0; round < 2; ++round) {
+         for (int i = 0; i < INIT_CONTAINER_SIZE * 5; ++i) {
+            if (!slru.get(i)) slru.put(i, i);
+            if (!lru.get(i)) lru.put(i, i);
+         }
+      }
+      for (int i = 1000; i < 1000 + INIT_CONTAINER_SIZE * 20; ++i) {
+         slru.put(i, i);
+         lru.put(i, i);
+      }
+      int slru_kept = 0, lru_kept = 0;
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 5; ++i) {
+         slru_kept += slru.contains(i);
+         lru_kept += lru.contains(i);
+      }
+      rtest::EQUAL(slru_kept, INIT_CONTAINER_SIZE * 5);
+      rtest::EQUAL(lru_kept, 0);
+      rtest::EQUAL(slru.size(), size_t(INIT_CONTAINER_SIZE * 10));
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
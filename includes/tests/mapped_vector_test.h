@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mapped_vector.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define MAPPED_TEST_SIZE 100000
+void mapped_vector_test() {
+   const std::string path = "mapped_vector_test.bin";
+
+   rtest::Tester::add_test(std::string("Write and reload"), [path]() {
+      std::vector<int> std_vector;
+      {
+         std::remove(path.c_str());
+         tinystl::mapped_vector<int> my_vector;
+         my_vector.open(path.c_str(), tinystl::mapped_vector<int>::read_write);
+         for (int i = 1; i <= MAPPED_TEST_SIZE; ++i) {
+            int x = rtest::Tester::get_random_int(-100, 100);
+            std_vector.push_back(x);
+            my_vector.push_back(x);
+         }
+      }
+      tinystl::mapped_vector<int> my_vector(
+          path.c_str(), tinystl::mapped_vector<int>::read_only);
+      my_vector.advise(tinystl::mapped_vector<int>::sequential);
+      rtest::EQUAL(my_vector.size(), std_vector.size());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Copy on write"), [path]() {
+      {
+         tinystl::mapped_vector<int> my_vector(
+             path.c_str(), tinystl::mapped_vector<int>::copy_on_write);
+         my_vector[0] = 12345;
+         for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_vector.push_back(i);
+         rtest::EQUAL(my_vector[0], 12345);
+         rtest::EQUAL(my_vector.back(), INIT_CONTAINER_SIZE);
+      }
+      // the file is untouched
+      tinystl::mapped_vector<int> my_vector(
+          path.c_str(), tinystl::mapped_vector<int>::read_only);
+      rtest::EQUAL(my_vector.size(), static_cast<size_t>(MAPPED_TEST_SIZE));
+      rtest::EQUAL(my_vector[0] != 12345, true);
+      std::remove(path.c_str());
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -0,0 +1,127 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "persistent_vector.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+// deep enough for a three level trie
+#define PERSISTENT_TEST_SIZE 40000
+void persistent_vector_test() {
+   rtest::Tester::add_test(std::string("Push back, set and pop back"), []() {
+      std::vector<int> std_vector;
+      tinystl::persistent_vector<int> my_vector;
+      for (int i = 0; i < PERSISTENT_TEST_SIZE; ++i) {
+         std_vector.push_back(i);
+         my_vector.push_back(i);
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 100; ++i) {
+         int pos = rtest::Tester::get_random_int(0, PERSISTENT_TEST_SIZE - 1);
+         std_vector[pos] = -i;
+         my_vector.set(pos, -i);
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      rtest::EQUAL(my_vector.back(), std_vector.back());
+
+      // back down through every level
+      bool same = true;
+      while (!std_vector.empty()) {
+         same = same && my_vector.size() == std_vector.size() &&
+                my_vector.back() == std_vector.back() &&
+                my_vector.front() == std_vector.front();
+         std_vector.pop_back();
+         my_vector.pop_back();
+      }
+      rtest::EQUAL(same, true);
+      rtest::EQUAL(my_vector.empty(), true);
+   });
+
+   rtest::Tester::add_test(std::string("Snapshots are independent"), []() {
+      tinystl::persistent_vector<std::string> my_vector;
+      for (int i = 0; i < PERSISTENT_TEST_SIZE / 10; ++i) {
+         my_vector.push_back(std::to_string(i));
+      }
+      tinystl::persistent_vector<std::string> snapshot = my_vector;
+      // nothing is copied until a write
+      rtest::EQUAL(&snapshot[0] == &my_vector[0], true);
+      rtest::EQUAL(&snapshot.back() == &my_vector.back(), true);
+
+      std::vector<tinystl::persistent_vector<std::string>> history;
+      std::vector<std::vector<std::string>> expected;
+      std::vector<std::string> model;
+      for (size_t i = 0; i < snapshot.size(); ++i) model.push_back(snapshot[i]);
+      for (int round = 0; round < INIT_CONTAINER_SIZE; ++round) {
+         for (int i = 0; i < INIT_CONTAINER_SIZE * 5; ++i) {
+            int op = rtest::Tester::get_random_int(0, 2);
+            if (op == 0 || model.empty()) {
+               model.push_back(std::to_string(round * 1000 + i));
+               my_vector.push_back(model.back());
+            } else if (op == 1) {
+               model.pop_back();
+               my_vector.pop_back();
+            } else {
+               int pos = rtest::Tester::get_random_int(
+                   0, static_cast<int>(model.size()) - 1);
+               model[pos] = "set" + std::to_string(i);
+               my_vector.set(pos, model[pos]);
+            }
+         }
+         history.push_back(my_vector);
+         expected.push_back(model);
+      }
+      for (size_t i = 0; i < history.size(); ++i) {
+         rtest::CONTAINER_EQUAL(expected[i], history[i]);
+      }
+      // the first snapshot never saw any of it
+      rtest::EQUAL(snapshot.size(), size_t(PERSISTENT_TEST_SIZE / 10));
+      rtest::EQUAL(snapshot.back(),
+                   std::to_string(PERSISTENT_TEST_SIZE / 10 - 1));
+   });
+
+   rtest::Tester::add_test(std::string("Iterators"), []() {
+      tinystl::persistent_vector<int> my_vector;
+      for (int i = 0; i < INIT_CONTAINER_SIZE * 100; ++i) {
+         my_vector.push_back(i);
+      }
+      tinystl::persistent_vector<int>::iterator it = my_vector.begin();
+      rtest::EQUAL(*(it + 500), 500);
+      rtest::EQUAL(my_vector.end() - it, std::ptrdiff_t(1000));
+      it += 999;
+      rtest::EQUAL(*it, 999);
+      bool ok = true;
+      for (int i = 999; i >= 0; --i, --it) ok = ok && *it == i;
+      rtest::EQUAL(ok, true);
+      long long sum = 0;
+      for (int x : my_vector) sum += x;
+      rtest::EQUAL(sum, 999LL * 1000 / 2);
+   });
+
+   rtest::Tester::add_test(std::string("Snapshots across threads"), []() {
+      tinystl::persistent_vector<int> my_vector;
+      for (int i = 0; i < PERSISTENT_TEST_SIZE; ++i) my_vector.push_back(0);
+      std::vector<std::thread> readers;
+      std::vector<int> consistent(4, 0);
+      for (int t = 0; t < 4; ++t) {
+         // each reader sees generation t everywhere
+         for (int i = 0; i < PERSISTENT_TEST_SIZE; i += 97) my_vector.set(i, t);
+         tinystl::persistent_vector<int> snapshot = my_vector;
+         readers.push_back(
+             std::thread([snapshot, t, &consistent]() {
+                bool ok = true;
+                for (int i = 0; i < PERSISTENT_TEST_SIZE; ++i) {
+                   ok = ok && snapshot[i] == (i % 97 == 0 ? t : 0);
+                }
+                consistent[t] = ok;
+             }));
+      }
+      for (size_t t = 0; t < readers.size(); ++t) readers[t].join();
+      std::vector<int> all(4, 1);
+      rtest::CONTAINER_EQUAL(all, consistent);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
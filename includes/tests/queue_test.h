@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "heap.h"
+#include "queue.h"
+#include "rtest.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define QUEUE_TEST_SIZE 1000
+void queue_test() {
+   rtest::Tester::add_test(std::string("Heap algorithms"), []() {
+      std::vector<int> std_vector;
+      for (int i = 1; i <= QUEUE_TEST_SIZE; ++i) {
+         std_vector.push_back(rtest::Tester::get_random_int(-100, 100));
+      }
+      tinystl::vector<int> my_vector(std_vector.data(),
+                                     std_vector.data() + std_vector.size());
+      tinystl::make_heap(my_vector.begin(), my_vector.end());
+      rtest::EQUAL(tinystl::is_heap(my_vector.begin(), my_vector.end()), true);
+      // replace the same element on both sides
+      std_vector.assign(my_vector.begin(), my_vector.end());
+      std_vector[QUEUE_TEST_SIZE / 2] = -1000;
+      my_vector[QUEUE_TEST_SIZE / 2] = 1000;
+      tinystl::update_heap(my_vector.begin(), my_vector.end(),
+                           my_vector.begin() + QUEUE_TEST_SIZE / 2);
+      rtest::EQUAL(my_vector.front(), 1000);
+      my_vector[0] = -1000;
+      tinystl::update_heap(my_vector.begin(), my_vector.end(),
+                           my_vector.begin());
+      rtest::EQUAL(tinystl::is_heap(my_vector.begin(), my_vector.end()), true);
+      tinystl::sort_heap(my_vector.begin(), my_vector.end());
+      std::sort(std_vector.begin(), std_vector.end());
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("Binary and 8-ary heaps"), []() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> binary, octal;
+      for (int i = 1; i <= QUEUE_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(x);
+         binary.push_back(x);
+         tinystl::push_heap<2>(binary.begin(), binary.end());
+         octal.push_back(x);
+         tinystl::push_heap<8>(octal.begin(), octal.end());
+      }
+      rtest::EQUAL(tinystl::is_heap<2>(binary.begin(), binary.end()), true);
+      rtest::EQUAL(tinystl::is_heap<8>(octal.begin(), octal.end()), true);
+      tinystl::sort_heap<2>(binary.begin(), binary.end());
+      tinystl::sort_heap<8>(octal.begin(), octal.end());
+      std::sort(std_vector.begin(), std_vector.end());
+      rtest::CONTAINER_EQUAL(std_vector, binary);
+      rtest::CONTAINER_EQUAL(std_vector, octal);
+   });
+
+   rtest::Tester::add_test(std::string("Priority queue"), []() {
+      std::vector<int> init;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) init.push_back(i * 7 % 10);
+      std::priority_queue<int, std::vector<int>, std::greater<int>> std_queue(
+          init.begin(), init.end());
+      tinystl::priority_queue<int, tinystl::vector<int>, std::greater<int>>
+          my_queue(init.data(), init.data() + init.size());
+      for (int i = 1; i <= QUEUE_TEST_SIZE; ++i) {
+         if (rtest::Tester::get_random_int(0, 2) == 0 && !std_queue.empty()) {
+            rtest::EQUAL(my_queue.top(), std_queue.top());
+            std_queue.pop();
+            my_queue.pop();
+         } else {
+            int x = rtest::Tester::get_random_int(-100, 100);
+            std_queue.push(x);
+            my_queue.push(x);
+         }
+      }
+      rtest::EQUAL(my_queue.size(), std_queue.size());
+   });
+
+   rtest::Tester::add_test(std::string("Indexed priority queue"), []() {
+      // a min queue of timer deadlines
+      std::vector<int> deadline(QUEUE_TEST_SIZE);
+      tinystl::indexed_priority_queue<int, std::greater<int>> my_queue(
+          QUEUE_TEST_SIZE);
+      for (size_t id = 0; id < QUEUE_TEST_SIZE; ++id) {
+         deadline[id] = rtest::Tester::get_random_int(0, 100000);
+         my_queue.push(id, deadline[id]);
+      }
+      for (size_t id = 0; id < QUEUE_TEST_SIZE; id += 3) {
+         deadline[id] = rtest::Tester::get_random_int(0, 100000);
+         my_queue.update(id, deadline[id]);
+      }
+      for (size_t id = 1; id < QUEUE_TEST_SIZE; id += 5) my_queue.erase(id);
+      rtest::EQUAL(my_queue.contains(1), false);
+      rtest::EQUAL(my_queue.key(3), deadline[3]);
+
+      std::vector<int> expected;
+      for (size_t id = 0; id < QUEUE_TEST_SIZE; ++id) {
+         if (id % 5 != 1) expected.push_back(deadline[id]);
+      }
+      std::sort(expected.begin(), expected.end());
+      std::vector<int> popped;
+      while (!my_queue.empty()) {
+         popped.push_back(my_queue.top_key());
+         rtest::EQUAL(deadline[my_queue.top()], my_queue.top_key());
+         my_queue.pop();
+      }
+      rtest::CONTAINER_EQUAL(expected, popped);
+   });
+
+   rtest::Tester::add_test(std::string("Copies are independent"), []() {
+      tinystl::priority_queue<int> my_queue;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) my_queue.push(i);
+      {
+         tinystl::priority_queue<int> copy = my_queue;
+         copy.push(100);
+         rtest::EQUAL(copy.top(), 100);
+      }
+      my_queue.push(5);
+      rtest::EQUAL(my_queue.top(), INIT_CONTAINER_SIZE);
+      rtest::EQUAL(my_queue.size(), size_t(INIT_CONTAINER_SIZE + 1));
+
+      tinystl::indexed_priority_queue<int> indexed(INIT_CONTAINER_SIZE);
+      indexed.push(1, 10);
+      {
+         tinystl::indexed_priority_queue<int> copy = indexed;
+         copy.push(2, 20);
+         copy.erase(1);
+         rtest::EQUAL(copy.top(), size_t(2));
+      }
+      indexed.push(3, 5);
+      rtest::EQUAL(indexed.top(), size_t(1));
+      rtest::EQUAL(indexed.contains(2), false);
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
@@ -0,0 +1,190 @@
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.h"
+#include "generator.h"
+#include "list.h"
+#include "ranges.h"
+#include "rtest.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define RANGES_TEST_SIZE 100
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+tinystl::generator<long long> fibonacci() {
+   long long a = 0, b = 1;
+   for (;;) {
+      co_yield a;
+      long long next = a + b;
+      a = b;
+      b = next;
+   }
+}
+
+tinystl::generator<std::string> words(int n) {
+   for (int i = 0; i < n; ++i) co_yield std::to_string(i);
+}
+#endif
+
+void ranges_test() {
+   rtest::Tester::add_test(std::string("Filter, transform and take"), []() {
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= RANGES_TEST_SIZE; ++i) my_vector.push_back(i);
+      int calls = 0;
+      auto pipeline = my_vector | tinystl::views::filter([&calls](int x) {
+                         ++calls;
+                         return x % 2 == 0;
+                      }) |
+                      tinystl::views::transform([](int x) { return x * x; }) |
+                      tinystl::views::take(5);
+      // nothing runs before the pipeline is iterated
+      rtest::EQUAL(calls, 0);
+      tinystl::vector<int> result = tinystl::to_vector(pipeline);
+      std::vector<int> expected = {4, 16, 36, 64, 100};
+      rtest::CONTAINER_EQUAL(expected, result);
+      rtest::EQUAL(calls <= 12, true);
+   });
+
+   rtest::Tester::add_test(std::string("Views over a list"), []() {
+      tinystl::list<int> my_list;
+      std::vector<std::string> expected;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_list.push_back(i);
+         if (i > 3) expected.push_back(std::to_string(i));
+      }
+      tinystl::vector<std::string> result =
+          my_list | tinystl::views::drop(3) |
+          tinystl::views::transform([](int x) { return std::to_string(x); }) |
+          tinystl::views::to_vector();
+      rtest::CONTAINER_EQUAL(expected, result);
+
+      tinystl::list<int> odd = tinystl::collect<tinystl::list<int>>(
+          my_list | tinystl::views::filter([](int x) { return x % 2; }));
+      rtest::EQUAL(static_cast<int>(odd.size()), INIT_CONTAINER_SIZE / 2);
+      rtest::EQUAL(odd.back(), 9);
+   });
+
+   rtest::Tester::add_test(std::string("Views own a temporary vector"), []() {
+      // the vector is moved into the view and along with every view built
+      // on it
+      tinystl::vector<int> result =
+          tinystl::vector<int>(INIT_CONTAINER_SIZE, 3) |
+          tinystl::views::transform([](int x) { return x * 2; }) |
+          tinystl::views::take(5) | tinystl::views::to_vector();
+      std::vector<int> expected(5, 6);
+      rtest::CONTAINER_EQUAL(expected, result);
+   });
+
+   rtest::Tester::add_test(std::string("Zip and chunk"), []() {
+      tinystl::vector<int> keys;
+      tinystl::list<std::string> names;
+      for (int i = 0; i < INIT_CONTAINER_SIZE; ++i) {
+         keys.push_back(i);
+         if (i < INIT_CONTAINER_SIZE / 2) names.push_back(std::to_string(i));
+      }
+      int pairs = 0;
+      for (std::pair<int&, std::string&> p :
+           tinystl::views::zip(keys, names)) {
+         rtest::EQUAL(std::to_string(p.first), p.second);
+         ++pairs;
+      }
+      rtest::EQUAL(pairs, INIT_CONTAINER_SIZE / 2);
+
+      // zip writes through to the containers
+      tinystl::vector<int> values(keys.begin(), keys.end());
+      for (auto p : tinystl::views::zip(keys, values)) p.second *= 2;
+      rtest::EQUAL(values.back(), 2 * (INIT_CONTAINER_SIZE - 1));
+
+      std::vector<int> sums;
+      for (auto c : keys | tinystl::views::chunk(3)) {
+         int sum = 0;
+         for (int x : c) sum += x;
+         sums.push_back(sum);
+      }
+      std::vector<int> expected = {3, 12, 21, 9};
+      rtest::CONTAINER_EQUAL(expected, sums);
+   });
+
+   rtest::Tester::add_test(std::string("Iterator categories"), []() {
+      tinystl::vector<int> my_vector;
+      tinystl::list<int> my_list;
+      for (int i = 0; i < INIT_CONTAINER_SIZE; ++i) {
+         my_vector.push_back(i);
+         my_list.push_back(i);
+      }
+      auto squares =
+          my_vector | tinystl::views::transform([](int x) { return x * x; });
+      typedef decltype(squares.begin()) squares_iterator;
+      rtest::EQUAL(
+          std::is_same<tinystl::iterator_traits<
+                           squares_iterator>::iterator_category,
+                       tinystl::random_access_iterator_tag>::value,
+          true);
+      // random access algorithms work on views
+      rtest::EQUAL(tinystl::lower_bound(squares.begin(), squares.end(), 49) -
+                       squares.begin(),
+                   std::ptrdiff_t(7));
+      auto first = my_vector | tinystl::views::take(RANGES_TEST_SIZE);
+      rtest::EQUAL(first.end() - first.begin(),
+                   std::ptrdiff_t(INIT_CONTAINER_SIZE));
+
+      auto evens =
+          my_list | tinystl::views::filter([](int x) { return x % 2 == 0; });
+      typedef decltype(evens.begin()) evens_iterator;
+      rtest::EQUAL(
+          std::is_same<
+              tinystl::iterator_traits<evens_iterator>::iterator_category,
+              tinystl::bidirectional_iterator_tag>::value,
+          true);
+      evens_iterator last = evens.end();
+      rtest::EQUAL(*--last, 8);
+      rtest::EQUAL(*--last, 6);
+
+      auto taken = my_list | tinystl::views::take(3);
+      typedef decltype(taken.begin()) taken_iterator;
+      rtest::EQUAL(
+          std::is_same<
+              tinystl::iterator_traits<taken_iterator>::iterator_category,
+              tinystl::forward_iterator_tag>::value,
+          true);
+   });
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+   rtest::Tester::add_test(std::string("Generators"), []() {
+      tinystl::vector<long long> result =
+          fibonacci() | tinystl::views::take(INIT_CONTAINER_SIZE) |
+          tinystl::views::to_vector();
+      std::vector<long long> expected = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34};
+      rtest::CONTAINER_EQUAL(expected, result);
+
+      tinystl::vector<long long> even =
+          fibonacci() |
+          tinystl::views::filter([](long long x) { return x % 2 == 0; }) |
+          tinystl::views::drop(1) | tinystl::views::take(3) |
+          tinystl::views::to_vector();
+      std::vector<long long> expected_even = {2, 8, 34};
+      rtest::CONTAINER_EQUAL(expected_even, even);
+
+      // a named generator can't be copied, the pipeline refers to it
+      tinystl::generator<long long> named = fibonacci();
+      tinystl::vector<long long> first =
+          named | tinystl::views::take(5) | tinystl::views::to_vector();
+      std::vector<long long> expected_first = {0, 1, 1, 2, 3};
+      rtest::CONTAINER_EQUAL(expected_first, first);
+
+      int n = 0;
+      for (const std::string& w : words(INIT_CONTAINER_SIZE)) {
+         rtest::EQUAL(w, std::to_string(n));
+         ++n;
+      }
+      rtest::EQUAL(n, INIT_CONTAINER_SIZE);
+   });
+#endif
+   rtest::Tester::run();
+}
+
+}  // namespace test
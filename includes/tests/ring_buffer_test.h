@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "algorithm.h"
+#include "ring_buffer.h"
+#include "rtest.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define RING_TEST_SIZE 1000
+void ring_buffer_test() {
+   rtest::Tester::add_test(std::string("Push and pop at both ends"), []() {
+      std::deque<int> std_deque;
+      tinystl::ring_buffer<int> my_buffer(100);
+      rtest::EQUAL(my_buffer.capacity(), size_t(128));
+      for (int i = 1; i <= RING_TEST_SIZE; ++i) {
+         int op = rtest::Tester::get_random_int(0, 3);
+         if (op == 0 && !std_deque.empty()) {
+            std_deque.pop_front();
+            my_buffer.pop_front();
+         } else if (op == 1 && !std_deque.empty()) {
+            std_deque.pop_back();
+            my_buffer.pop_back();
+         } else if (!my_buffer.full()) {
+            if (op == 2) {
+               std_deque.push_front(i);
+               my_buffer.push_front(i);
+            } else {
+               std_deque.push_back(i);
+               my_buffer.push_back(i);
+            }
+         }
+      }
+      rtest::EQUAL(my_buffer.size(), std_deque.size());
+      rtest::CONTAINER_EQUAL(std_deque, my_buffer);
+   });
+
+   rtest::Tester::add_test(std::string("Bulk push and pop"), []() {
+      std::deque<int> std_deque;
+      tinystl::ring_buffer<int> my_buffer(64);
+      std::vector<int> chunk(INIT_CONTAINER_SIZE * 3);
+      std::vector<int> out(INIT_CONTAINER_SIZE * 3);
+      for (int round = 0; round < 50; ++round) {
+         for (size_t i = 0; i < chunk.size(); ++i)
+            chunk[i] = round * 100 + static_cast<int>(i);
+         if (my_buffer.capacity() - my_buffer.size() >= chunk.size()) {
+            my_buffer.push_n(chunk.data(), chunk.size());
+            std_deque.insert(std_deque.end(), chunk.begin(), chunk.end());
+         }
+         size_t n = rtest::Tester::get_random_int(0, INIT_CONTAINER_SIZE * 3);
+         n = std::min(n, my_buffer.size());
+         my_buffer.pop_n(out.begin(), n);
+         rtest::EQUAL(std::equal(out.begin(), out.begin() + n,
+                                 std_deque.begin()),
+                      true);
+         std_deque.erase(std_deque.begin(), std_deque.begin() + n);
+      }
+      rtest::CONTAINER_EQUAL(std_deque, my_buffer);
+   });
+
+   rtest::Tester::add_test(std::string("Two spans"), []() {
+      tinystl::ring_buffer<int> my_buffer(16);
+      for (int i = 0; i < 12; ++i) my_buffer.push_back(i);
+      my_buffer.pop_n(8);
+      for (int i = 12; i < 20; ++i) my_buffer.push_back(i);
+      std::pair<int*, size_t> one = my_buffer.array_one();
+      std::pair<int*, size_t> two = my_buffer.array_two();
+      rtest::EQUAL(one.second + two.second, my_buffer.size());
+      std::vector<int> joined(one.first, one.first + one.second);
+      joined.insert(joined.end(), two.first, two.first + two.second);
+      rtest::CONTAINER_EQUAL(joined, my_buffer);
+      rtest::EQUAL(joined.front(), 8);
+      rtest::EQUAL(joined.back(), 19);
+   });
+
+   rtest::Tester::add_test(std::string("Random access iterator"), []() {
+      std::vector<std::string> std_vector;
+      tinystl::ring_buffer<std::string> my_buffer(RING_TEST_SIZE);
+      for (int i = 1; i <= RING_TEST_SIZE; ++i) {
+         my_buffer.push_back(std::to_string(i));
+         if (i % 3 == 0) my_buffer.pop_front();
+      }
+      for (size_t i = 0; i < my_buffer.size(); ++i)
+         std_vector.push_back(my_buffer[i]);
+      std::sort(std_vector.begin(), std_vector.end());
+      tinystl::sort(my_buffer.begin(), my_buffer.end());
+      rtest::EQUAL(my_buffer.end() - my_buffer.begin(),
+                   std::ptrdiff_t(std_vector.size()));
+      rtest::CONTAINER_EQUAL(std_vector, my_buffer);
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
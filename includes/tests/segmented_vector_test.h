@@ -0,0 +1,113 @@
+#include <string>
+#include <vector>
+
+#include "rtest.h"
+#include "segmented_vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SEGMENTED_TEST_SIZE 1000
+void segmented_vector_test() {
+   rtest::Tester::add_test(std::string("Push back and index"), []() {
+      std::vector<int> std_vector;
+      tinystl::segmented_vector<int> my_vector;
+      for (int i = 1; i <= SEGMENTED_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      rtest::EQUAL(my_vector[SEGMENTED_TEST_SIZE / 2],
+                   std_vector[SEGMENTED_TEST_SIZE / 2]);
+      rtest::EQUAL(my_vector.front(), std_vector.front());
+      rtest::EQUAL(my_vector.back(), std_vector.back());
+      rtest::EQUAL(my_vector.end() - my_vector.begin(),
+                   std::ptrdiff_t(SEGMENTED_TEST_SIZE));
+
+      for (int i = 0; i < SEGMENTED_TEST_SIZE / 3; ++i) {
+         std_vector.pop_back();
+         my_vector.pop_back();
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+   });
+
+   rtest::Tester::add_test(std::string("References never move"), []() {
+      tinystl::segmented_vector<std::string> my_vector;
+      my_vector.push_back(std::string("first"));
+      std::string* first = &my_vector[0];
+      std::vector<std::string*> pointers;
+      for (int i = 1; i <= SEGMENTED_TEST_SIZE; ++i) {
+         my_vector.push_back(std::to_string(i));
+         pointers.push_back(&my_vector.back());
+      }
+      rtest::EQUAL(first == &my_vector[0], true);
+      rtest::EQUAL(*first, std::string("first"));
+      bool stable = true;
+      for (int i = 1; i <= SEGMENTED_TEST_SIZE; ++i) {
+         stable = stable && pointers[i - 1] == &my_vector[i];
+      }
+      rtest::EQUAL(stable, true);
+   });
+
+   rtest::Tester::add_test(std::string("Random access iterators"), []() {
+      tinystl::segmented_vector<int> my_vector;
+      for (int i = 0; i < SEGMENTED_TEST_SIZE; ++i) my_vector.push_back(i);
+      tinystl::segmented_vector<int>::iterator it = my_vector.begin();
+      bool ok = true;
+      for (int i = 0; i < SEGMENTED_TEST_SIZE; i += 7) {
+         ok = ok && *(it + i) == i && it[i] == i;
+         ok = ok && (my_vector.end() - (SEGMENTED_TEST_SIZE - i)) - it == i;
+      }
+      rtest::EQUAL(ok, true);
+      it += SEGMENTED_TEST_SIZE - 1;
+      rtest::EQUAL(*it, SEGMENTED_TEST_SIZE - 1);
+      it -= SEGMENTED_TEST_SIZE / 2;
+      rtest::EQUAL(*it, SEGMENTED_TEST_SIZE / 2 - 1);
+      rtest::EQUAL(it < my_vector.end(), true);
+      rtest::EQUAL(my_vector.begin() < it, true);
+
+      int expected = SEGMENTED_TEST_SIZE;
+      tinystl::segmented_vector<int>::iterator last = my_vector.end();
+      while (last != my_vector.begin()) {
+         --last;
+         --expected;
+         ok = ok && *last == expected;
+      }
+      rtest::EQUAL(ok, true);
+      rtest::EQUAL(expected, 0);
+   });
+
+   rtest::Tester::add_test(std::string("Resize, reserve and segments"), []() {
+      tinystl::segmented_vector<int> my_vector(INIT_CONTAINER_SIZE, 3);
+      my_vector.resize(SEGMENTED_TEST_SIZE, 1);
+      rtest::EQUAL(my_vector.size(), size_t(SEGMENTED_TEST_SIZE));
+      rtest::EQUAL(my_vector[INIT_CONTAINER_SIZE - 1], 3);
+      rtest::EQUAL(my_vector[INIT_CONTAINER_SIZE], 1);
+
+      long long sum = 0, segments = 0;
+      my_vector.for_each_segment([&sum, &segments](int* first, int* last) {
+         for (; first != last; ++first) sum += *first;
+         ++segments;
+      });
+      rtest::EQUAL(sum, 2LL * INIT_CONTAINER_SIZE + SEGMENTED_TEST_SIZE);
+      rtest::EQUAL(segments > 1, true);
+
+      my_vector.resize(INIT_CONTAINER_SIZE);
+      rtest::EQUAL(my_vector.size(), size_t(INIT_CONTAINER_SIZE));
+      my_vector.shrink_to_fit();
+      rtest::EQUAL(my_vector.capacity() < size_t(SEGMENTED_TEST_SIZE), true);
+      my_vector.reserve(SEGMENTED_TEST_SIZE);
+      rtest::EQUAL(my_vector.capacity() >= size_t(SEGMENTED_TEST_SIZE), true);
+
+      tinystl::segmented_vector<int> copy(my_vector);
+      rtest::CONTAINER_EQUAL(my_vector, copy);
+      my_vector.clear();
+      rtest::EQUAL(my_vector.empty(), true);
+      rtest::EQUAL(my_vector.begin() == my_vector.end(), true);
+      my_vector = copy;
+      rtest::CONTAINER_EQUAL(copy, my_vector);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
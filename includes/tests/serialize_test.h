@@ -0,0 +1,155 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "list.h"
+#include "rtest.h"
+#include "serialize.h"
+#include "vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SERIALIZE_TEST_SIZE 5000
+
+struct named {
+   std::string name;
+   int value;
+
+   bool operator==(const named& x) const {
+      return name == x.name && value == x.value;
+   }
+   bool operator!=(const named& x) const { return !(*this == x); }
+};
+}  // namespace test
+
+template <>
+struct tinystl::codec<test::named> {
+   static void encode(tinystl::byte_writer& out, const test::named& x) {
+      out.write_pod(x.name.size());
+      out.write(x.name.data(), x.name.size());
+      out.write_pod(x.value);
+   }
+   static test::named decode(tinystl::byte_reader& in) {
+      test::named x;
+      x.name.resize(in.read_pod<size_t>());
+      in.read(&x.name[0], x.name.size());
+      x.value = in.read_pod<int>();
+      return x;
+   }
+};
+
+namespace test {
+void serialize_test() {
+   const std::string path = "serialize_test.bin";
+
+   rtest::Tester::add_test(std::string("Vector of POD"), [path]() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= SERIALIZE_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+      }
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      rtest::EQUAL(tinystl::serialize(fd, my_vector), true);
+      close(fd);
+
+      tinystl::vector<int> loaded(INIT_CONTAINER_SIZE, 0);
+      fd = open(path.c_str(), O_RDONLY);
+      rtest::EQUAL(tinystl::deserialize(fd, loaded), true);
+      close(fd);
+      rtest::CONTAINER_EQUAL(std_vector, loaded);
+   });
+
+   rtest::Tester::add_test(std::string("List of POD"), [path]() {
+      std::list<int> std_list;
+      tinystl::list<int> my_list;
+      for (int i = 1; i <= SERIALIZE_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_list.push_back(x);
+         my_list.push_back(x);
+      }
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      rtest::EQUAL(tinystl::serialize(fd, my_list), true);
+      close(fd);
+
+      tinystl::list<int> loaded;
+      loaded.push_back(1);
+      fd = open(path.c_str(), O_RDONLY);
+      rtest::EQUAL(tinystl::deserialize(fd, loaded), true);
+      close(fd);
+      rtest::CONTAINER_EQUAL(std_list, loaded);
+   });
+
+   rtest::Tester::add_test(std::string("Chunked reader"), [path]() {
+      std::vector<int> std_vector;
+      tinystl::vector<int> my_vector;
+      for (int i = 1; i <= SERIALIZE_TEST_SIZE; ++i) {
+         std_vector.push_back(i);
+         my_vector.push_back(i);
+      }
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      tinystl::serialize(fd, my_vector);
+      close(fd);
+
+      tinystl::vector<int> loaded;
+      fd = open(path.c_str(), O_RDONLY);
+      tinystl::vector_reader<int> reader(fd);
+      while (reader.remaining() > 0) {
+         size_t before = loaded.size();
+         size_t n = reader.read_chunk(loaded, 777);
+         rtest::EQUAL(loaded.size(), before + n);
+      }
+      close(fd);
+      rtest::EQUAL(reader.good(), true);
+      rtest::CONTAINER_EQUAL(std_vector, loaded);
+   });
+
+   rtest::Tester::add_test(std::string("Codec for non-POD"), [path]() {
+      std::vector<named> std_vector;
+      tinystl::vector<named> my_vector;
+      tinystl::list<named> my_list;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         named x = {std::string(i * 3, 'a' + i), i};
+         std_vector.push_back(x);
+         my_vector.push_back(x);
+         my_list.push_back(x);
+      }
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      tinystl::serialize(fd, my_vector);
+      tinystl::serialize(fd, my_list);
+      close(fd);
+
+      tinystl::vector<named> loaded_vector;
+      tinystl::list<named> loaded_list;
+      fd = open(path.c_str(), O_RDONLY);
+      rtest::EQUAL(tinystl::deserialize(fd, loaded_vector), true);
+      // the list stream follows the vector stream on the same fd
+      rtest::EQUAL(tinystl::deserialize(fd, loaded_list), true);
+      rtest::EQUAL(lseek(fd, 0, SEEK_CUR), lseek(fd, 0, SEEK_END));
+      close(fd);
+      rtest::CONTAINER_EQUAL(std_vector, loaded_vector);
+      rtest::CONTAINER_EQUAL(std_vector, loaded_list);
+   });
+
+   rtest::Tester::add_test(std::string("Rejects other element types"),
+                           [path]() {
+      tinystl::vector<int> my_vector(INIT_CONTAINER_SIZE, 1);
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      tinystl::serialize(fd, my_vector);
+      close(fd);
+
+      tinystl::vector<double> loaded;
+      fd = open(path.c_str(), O_RDONLY);
+      rtest::EQUAL(tinystl::deserialize(fd, loaded), false);
+      close(fd);
+      std::remove(path.c_str());
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
@@ -0,0 +1,90 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rtest.h"
+#include "slot_map.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SLOT_MAP_TEST_SIZE 10000
+void slot_map_test() {
+   rtest::Tester::add_test(std::string("Insert, erase and stale keys"), []() {
+      tinystl::slot_map<std::string> my_map;
+      tinystl::slot_key a = my_map.insert("a");
+      tinystl::slot_key b = my_map.insert("b");
+      tinystl::slot_key c = my_map.insert("c");
+      rtest::EQUAL(my_map[b], std::string("b"));
+      rtest::EQUAL(my_map.erase(a), true);
+      rtest::EQUAL(my_map.erase(a), false);
+      rtest::EQUAL(my_map.find(a) == 0, true);
+      // c was moved into the hole and its key still works
+      rtest::EQUAL(my_map[c], std::string("c"));
+      rtest::EQUAL(my_map.size(), size_t(2));
+
+      // the slot of a is reused under a new generation
+      tinystl::slot_key d = my_map.insert("d");
+      rtest::EQUAL(d.index, a.index);
+      rtest::EQUAL(d != a, true);
+      rtest::EQUAL(my_map.contains(a), false);
+      rtest::EQUAL(my_map[d], std::string("d"));
+      rtest::EQUAL(my_map.slot_count(), size_t(3));
+
+      tinystl::slot_key zero = {0, 0};
+      rtest::EQUAL(my_map.contains(zero), false);
+      my_map.clear();
+      rtest::EQUAL(my_map.empty(), true);
+      rtest::EQUAL(my_map.contains(b) || my_map.contains(d), false);
+   });
+
+   rtest::Tester::add_test(std::string("Same as map"), []() {
+      std::map<int, int> std_map;  // handle id to value
+      std::vector<tinystl::slot_key> keys;
+      std::vector<int> ids;
+      tinystl::slot_map<int> my_map;
+      bool same = true;
+      for (int i = 0; i < SLOT_MAP_TEST_SIZE; ++i) {
+         int op = rtest::Tester::get_random_int(0, 2);
+         if (op < 2 || keys.empty()) {
+            keys.push_back(my_map.insert(i));
+            ids.push_back(i);
+            std_map[i] = i;
+         } else {
+            size_t j = static_cast<size_t>(rtest::Tester::get_random_int(
+                0, static_cast<int>(keys.size()) - 1));
+            bool live = std_map.erase(ids[j]) == 1;
+            same = same && my_map.erase(keys[j]) == live;
+         }
+      }
+      for (size_t j = 0; j < keys.size(); ++j) {
+         std::map<int, int>::iterator it = std_map.find(ids[j]);
+         int* value = my_map.find(keys[j]);
+         same = same && (value != 0) == (it != std_map.end()) &&
+                (!value || *value == it->second);
+      }
+      rtest::EQUAL(same, true);
+      rtest::EQUAL(my_map.size(), std_map.size());
+   });
+
+   rtest::Tester::add_test(std::string("Dense iteration"), []() {
+      tinystl::slot_map<int> my_map;
+      my_map.reserve(INIT_CONTAINER_SIZE);
+      std::vector<tinystl::slot_key> keys;
+      for (int i = 0; i < INIT_CONTAINER_SIZE; ++i) {
+         keys.push_back(my_map.insert(i));
+      }
+      for (int i = 0; i < INIT_CONTAINER_SIZE; i += 2) my_map.erase(keys[i]);
+      int sum = 0, n = 0;
+      bool keys_match = true;
+      for (int* it = my_map.begin(); it != my_map.end(); ++it, ++n) {
+         sum += *it;
+         keys_match = keys_match && my_map.key_of(it) == keys[*it];
+      }
+      rtest::EQUAL(n, INIT_CONTAINER_SIZE / 2);
+      rtest::EQUAL(sum, 1 + 3 + 5 + 7 + 9);
+      rtest::EQUAL(keys_match, true);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "algorithm.h"
+#include "rtest.h"
+#include "soa_vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define SOA_TEST_SIZE 1000
+void soa_vector_test() {
+   rtest::Tester::add_test(std::string("Push back into columns"), []() {
+      std::vector<int> std_ids;
+      std::vector<double> std_prices;
+      tinystl::soa_vector<int, double, char> my_vector;
+      for (int i = 1; i <= SOA_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_ids.push_back(x);
+         std_prices.push_back(x / 4.0);
+         my_vector.push_back(x, x / 4.0, 'a');
+      }
+      rtest::EQUAL(my_vector.size(), std_ids.size());
+      tinystl::column_span<int> ids = my_vector.column<0>();
+      tinystl::column_span<double> prices = my_vector.column<1>();
+      rtest::CONTAINER_EQUAL(std_ids, ids);
+      rtest::CONTAINER_EQUAL(std_prices, prices);
+      rtest::EQUAL(tinystl::get<2>(my_vector.back()), 'a');
+   });
+
+   rtest::Tester::add_test(std::string("Aligned columns"), []() {
+      tinystl::soa_vector<char, short, double> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_vector.push_back(std::make_tuple(char(i), short(i), double(i)));
+         size_t a = reinterpret_cast<size_t>(my_vector.data<0>());
+         size_t b = reinterpret_cast<size_t>(my_vector.data<1>());
+         size_t c = reinterpret_cast<size_t>(my_vector.data<2>());
+         rtest::EQUAL((a | b | c) % 64, size_t(0));
+      }
+   });
+
+   rtest::Tester::add_test(std::string("Proxy reference"), []() {
+      tinystl::soa_vector<int, std::string> my_vector;
+      for (int i = 1; i <= INIT_CONTAINER_SIZE; ++i) {
+         my_vector.push_back(i, std::string(i, 'x'));
+      }
+      my_vector[0] = std::make_tuple(100, std::string("first"));
+      my_vector[1] = my_vector[0];
+      swap(my_vector[2], my_vector[3]);
+      std::tuple<int, std::string> row = my_vector[1];
+      rtest::EQUAL(std::get<0>(row), 100);
+      rtest::EQUAL(std::get<1>(row), std::string("first"));
+      rtest::EQUAL(tinystl::get<0>(my_vector[2]), 4);
+      rtest::EQUAL(tinystl::get<1>(my_vector[3]), std::string(3, 'x'));
+      my_vector.pop_back();
+      my_vector.resize(INIT_CONTAINER_SIZE * 2);
+      rtest::EQUAL(tinystl::get<0>(my_vector.back()), 0);
+      rtest::EQUAL(tinystl::get<1>(my_vector.back()), std::string());
+   });
+
+   rtest::Tester::add_test(std::string("Sort rows"), []() {
+      std::vector<std::tuple<int, int>> std_vector;
+      tinystl::soa_vector<int, int> my_vector;
+      for (int i = 1; i <= SOA_TEST_SIZE; ++i) {
+         int x = rtest::Tester::get_random_int(-100, 100);
+         std_vector.push_back(std::make_tuple(x, i));
+         my_vector.push_back(x, i);
+      }
+      typedef std::tuple<int, int> row;
+      std::sort(std_vector.begin(), std_vector.end());
+      tinystl::sort(my_vector.begin(), my_vector.end(),
+                    [](const row& a, const row& b) { return a < b; });
+      bool same = true;
+      for (size_t i = 0; i < std_vector.size(); ++i) {
+         same = same && row(my_vector[i]) == std_vector[i];
+      }
+      rtest::EQUAL(same, true);
+   });
+
+   rtest::Tester::run();
+}
+}  // namespace test
@@ -0,0 +1,105 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rtest.h"
+#include "static_vector.h"
+
+namespace test {
+#define INIT_CONTAINER_SIZE 10
+#define STATIC_VECTOR_TEST_SIZE 1000
+
+constexpr int static_vector_constexpr_sum() {
+   tinystl::static_vector<int, 8> v = {1, 2, 3};
+   v.push_back(4);
+   v.pop_back();
+   v.resize(5, 10);
+   int sum = 0;
+   for (size_t i = 0; i < v.size(); ++i) sum += v[i];
+   return sum;
+}
+
+void static_vector_test() {
+   rtest::Tester::add_test(std::string("Same as vector"), []() {
+      std::vector<int> std_vector;
+      // room for three more elements per step
+      tinystl::static_vector<int, STATIC_VECTOR_TEST_SIZE * 3> my_vector;
+      for (int i = 0; i < STATIC_VECTOR_TEST_SIZE; ++i) {
+         int op = rtest::Tester::get_random_int(0, 3);
+         if (op <= 1 || std_vector.empty()) {
+            size_t pos = static_cast<size_t>(rtest::Tester::get_random_int(
+                0, static_cast<int>(std_vector.size())));
+            if (op == 0) {
+               std_vector.insert(std_vector.begin() + pos, i);
+               my_vector.insert(my_vector.begin() + pos, i);
+            } else {
+               std_vector.insert(std_vector.begin() + pos, 3, i);
+               my_vector.insert(my_vector.begin() + pos, 3, i);
+            }
+         } else if (op == 2) {
+            size_t pos = static_cast<size_t>(rtest::Tester::get_random_int(
+                0, static_cast<int>(std_vector.size()) - 1));
+            std_vector.erase(std_vector.begin() + pos);
+            my_vector.erase(my_vector.begin() + pos);
+         } else {
+            std_vector.push_back(-i);
+            my_vector.push_back(-i);
+         }
+      }
+      rtest::CONTAINER_EQUAL(std_vector, my_vector);
+      my_vector.erase(my_vector.begin(), my_vector.begin() + 2);
+      my_vector.resize(INIT_CONTAINER_SIZE);
+      rtest::EQUAL(my_vector.size(), size_t(INIT_CONTAINER_SIZE));
+      rtest::EQUAL(my_vector[0], std_vector[2]);
+   });
+
+   rtest::Tester::add_test(std::string("Full is an error"), []() {
+      tinystl::static_vector<std::string, 4> my_vector(size_t(3), "x");
+      rtest::EQUAL(my_vector.try_push_back("y"), true);
+      rtest::EQUAL(my_vector.try_push_back("z"), false);
+      rtest::EQUAL(my_vector.full(), true);
+      bool thrown = false;
+      try {
+         my_vector.push_back("z");
+      } catch (const std::length_error&) {
+         thrown = true;
+      }
+      rtest::EQUAL(thrown, true);
+      thrown = false;
+      try {
+         my_vector.insert(my_vector.begin(), 2, "w");
+      } catch (const std::length_error&) {
+         thrown = true;
+      }
+      rtest::EQUAL(thrown, true);
+      // nothing changed
+      rtest::EQUAL(my_vector.size(), size_t(4));
+      rtest::EQUAL(my_vector.back(), std::string("y"));
+      my_vector.pop_back();
+      my_vector.insert(my_vector.begin(), "first");
+      rtest::EQUAL(my_vector.front(), std::string("first"));
+   });
+
+   rtest::Tester::add_test(std::string("Copies and constexpr"), []() {
+      tinystl::static_vector<std::string, INIT_CONTAINER_SIZE> a;
+      for (int i = 0; i < INIT_CONTAINER_SIZE / 2; ++i) {
+         a.push_back(std::to_string(i));
+      }
+      tinystl::static_vector<std::string, INIT_CONTAINER_SIZE> b(a);
+      a.clear();
+      rtest::EQUAL(b.size(), size_t(INIT_CONTAINER_SIZE / 2));
+      rtest::EQUAL(b[4], std::string("4"));
+      a = b;
+      rtest::EQUAL(a[1], std::string("1"));
+
+      static_assert(static_vector_constexpr_sum() == 26, "constexpr");
+      constexpr tinystl::static_vector<int, 4> table = {2, 3, 5, 7};
+      static_assert(table.size() == 4 && table[3] == 7, "literal type");
+      int values[] = {4, 5, 6};
+      tinystl::static_vector<int, 4> c(values, values + 3);
+      rtest::EQUAL(c.back(), 6);
+   });
+   rtest::Tester::run();
+}
+
+}  // namespace test
@@ -1,5 +1,6 @@
 #ifndef _TYPE_TRAIT_H_
 #define _TYPE_TRAIT_H_
+#include <string>
 
 namespace tinystl {
 struct _true_type {};
@@ -208,6 +209,84 @@ struct _type_traits<const signed char*> {
    typedef _true_type is_POD_type;
 };
 
+// tells a (first, last) iterator pair from an (n, value) pair of integers
+template <class T>
+struct _is_integer {
+   typedef _false_type integral;
+};
+template <>
+struct _is_integer<bool> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<char> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<signed char> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<unsigned char> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<wchar_t> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<short> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<unsigned short> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<int> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<unsigned int> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<long> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<unsigned long> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<long long> {
+   typedef _true_type integral;
+};
+template <>
+struct _is_integer<unsigned long long> {
+   typedef _true_type integral;
+};
+
+// the name of T without rtti, e.g.
+// "const char* tinystl::__type_name() [with T = tinystl::__list_node<int>]"
+template <class T>
+inline const char* __type_name() {
+#if defined(_MSC_VER) && !defined(__clang__)
+   return __FUNCSIG__;
+#else
+   return __PRETTY_FUNCTION__;
+#endif
+}
+
+// the "T" part of a __type_name() string
+inline std::string __short_type_name(const std::string& pretty) {
+   size_t pos = pretty.find("T = ");
+   if (pos == std::string::npos) return pretty;
+   size_t end = pretty.find_last_of(";]");
+   if (end == std::string::npos || end < pos) return pretty.substr(pos + 4);
+   return pretty.substr(pos + 4, end - pos - 4);
+}
+
 }  // namespace tinystl
 
 #endif
\ No newline at end of file
@@ -2,8 +2,9 @@
 #define _UNINITIALIZED_H_
 #include <wchar.h>
 
-#include <algorithm>
+#include <cstring>
 
+#include "algobase.h"
 #include "construct.h"
 #include "iterator.h"
 #include "type_traits.h"
@@ -30,8 +31,9 @@ inline ForwardIterator __uninitialized_fill_n(ForwardIterator first, Size n,
 template <class ForwardIterator, class Size, class T>
 inline ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n,
                                                   const T& x, _true_type) {
-   // TODO:
-   return std::fill_n(first,n,x);
+   __COUNT_OPS(typename iterator_traits<ForwardIterator>::value_type,
+               __op_copy, n);
+   return tinystl::fill_n(first, n, x);
 }
 
 template <class ForwardIterator, class Size, class T>
@@ -71,7 +73,10 @@ inline ForwardIterator __uninitialized_copy_aux(InputIterator first,
                                                 InputIterator last,
                                                 ForwardIterator result,
                                                 _true_type) {
-   return std::copy(first, last, result);
+   ForwardIterator cur = tinystl::copy(first, last, result);
+   __COUNT_OPS(typename iterator_traits<ForwardIterator>::value_type,
+               __op_copy, tinystl::distance(result, cur));
+   return cur;
 }
 
 template <class InputIterator, class ForwardIterator>
@@ -90,22 +95,30 @@ inline ForwardIterator __uninitialized_copy_aux(InputIterator first,
 inline char* uninitialized_copy(const char* first, const char* last,
                                 char* result) {
    memmove(result, first, last - first);
+   __COUNT_OPS(char, __op_copy, last - first);
    return result + (last - first);
 }
 
 inline wchar_t* uninitialized_copy(const wchar_t* first, const wchar_t* last,
                                    wchar_t* result) {
    memmove(result, first, sizeof(wchar_t) * (last - first));
+   __COUNT_OPS(wchar_t, __op_copy, last - first);
    return result + (last - first);
 }
 
+// declare
+template <class ForwardIterator, class T, class T1>
+inline ForwardIterator __uninitialized_fill(ForwardIterator first,
+                                            ForwardIterator last, const T& x,
+                                            T1*);
+
 template <class ForwardIterator, class T>
 inline void uninitialized_fill(ForwardIterator first, ForwardIterator last,
                                const T& x) {
    __uninitialized_fill(first, last, x, value_type(first));
 }
 
-template <class ForwardIterator, class Size, class T, class T1>
+template <class ForwardIterator, class T, class T1>
 inline ForwardIterator __uninitialized_fill(ForwardIterator first,
                                             ForwardIterator last, const T& x,
                                             T1*) {
@@ -113,14 +126,17 @@ inline ForwardIterator __uninitialized_fill(ForwardIterator first,
    return __uninitialized_fill_aux(first, last, x, is_POD());
 }
 
-template <class ForwardIterator, class Size, class T>
+template <class ForwardIterator, class T>
 inline ForwardIterator __uninitialized_fill_aux(ForwardIterator first,
                                                 ForwardIterator last,
                                                 const T& x, _true_type) {
-   std::fill(first, last, x);
+   __COUNT_OPS(typename iterator_traits<ForwardIterator>::value_type,
+               __op_copy, tinystl::distance(first, last));
+   tinystl::fill(first, last, x);
+   return last;
 }
 
-template <class ForwardIterator, class Size, class T>
+template <class ForwardIterator, class T>
 inline ForwardIterator __uninitialized_fill_aux(ForwardIterator first,
                                                 ForwardIterator last,
                                                 const T& x, _false_type) {
@@ -129,6 +145,7 @@ inline ForwardIterator __uninitialized_fill_aux(ForwardIterator first,
    for (; cur != last; ++cur) {
       construct(&*cur, x);
    }
+   return cur;
 }
 };  // namespace tinystl
 
@@ -1,5 +1,9 @@
-#include <algorithm>
+#ifndef _VECTOR_H_
+#define _VECTOR_H_
+#include <iostream>
+#include <utility>
 
+#include "algobase.h"
 #include "allocator.h"
 #include "construct.h"
 #include "iterator.h"
@@ -7,8 +11,18 @@
 #include "uninitialized.h"
 
 namespace tinystl {
+struct __container_io;
+
+// capacity for growing old_size elements by n: at least double, so that
+// push_back is amortized constant
+inline size_t __vector_next_capacity(size_t old_size, size_t n) {
+   return old_size + (old_size > n ? old_size : n);
+}
+
 template <class T, class Alloc = tinystl::alloc>
 class vector {
+   friend struct __container_io;
+
   public:
    typedef T value_type;
    typedef value_type* pointer;
@@ -23,14 +37,13 @@ class vector {
   protected:
    iterator start, finish, end_of_storage;
 
-   void insert(iterator pos, size_type n, const T& x);
    void insert_aux(iterator pos, const T& x);
    void deallocate() {
       if (start) data_allocator::deallocate(start, end_of_storage - start);
    }
    iterator allocate_and_fill(size_type n, const T& x) {
       iterator result = data_allocator::allocate(n);
-      uninitialized_fill_n(result, n, x);
+      tinystl::uninitialized_fill_n(result, n, x);
       return result;
    }
    void fill_initialize(size_type n, const T& value) {
@@ -38,6 +51,34 @@ class vector {
       finish = start + n;
       end_of_storage = finish;
    }
+   template <class Integer>
+   void initialize_aux(Integer n, Integer value, _true_type) {
+      fill_initialize(n, value);
+   }
+   template <class InputIterator>
+   void initialize_aux(InputIterator first, InputIterator last, _false_type) {
+      range_initialize(first, last, iterator_category(first));
+   }
+   template <class InputIterator>
+   void range_initialize(InputIterator first, InputIterator last,
+                         input_iterator_tag) {
+      start = finish = end_of_storage = 0;
+      for (; first != last; ++first) push_back(*first);
+   }
+   // size known up front, a single allocation
+   template <class ForwardIterator>
+   void range_initialize(ForwardIterator first, ForwardIterator last,
+                         forward_iterator_tag) {
+      size_type n = static_cast<size_type>(tinystl::distance(first, last));
+      start = data_allocator::allocate(n);
+      try {
+         finish = tinystl::uninitialized_copy(first, last, start);
+      } catch (...) {
+         data_allocator::deallocate(start, n);
+         throw;
+      }
+      end_of_storage = finish;
+   }
 
   public:
    iterator begin() const { return start; }
@@ -54,17 +95,40 @@ class vector {
    vector(int n, const T& value) { fill_initialize(n, value); }
    vector(long long n, const T& value) { fill_initialize(n, value); }
    explicit vector(size_type n) { fill_initialize(n, T()); }
+   template <class InputIterator>
+   vector(InputIterator first, InputIterator last) {
+      typedef typename _is_integer<InputIterator>::integral integral;
+      initialize_aux(first, last, integral());
+   }
+   vector(const vector& x) {
+      range_initialize(x.begin(), x.end(), forward_iterator_tag());
+   }
+   vector(vector&& x) noexcept
+       : start(x.start), finish(x.finish), end_of_storage(x.end_of_storage) {
+      x.start = x.finish = x.end_of_storage = 0;
+   }
+   // copy or move assignment, by way of the parameter
+   vector& operator=(vector x) noexcept {
+      swap(x);
+      return *this;
+   }
    ~vector() {
-      destroy(start, finish);
+      tinystl::destroy(start, finish);
       deallocate();
    }
 
+   void swap(vector& x) noexcept {
+      std::swap(start, x.start);
+      std::swap(finish, x.finish);
+      std::swap(end_of_storage, x.end_of_storage);
+   }
+
    reference front() { return *(begin()); }
    reference back() { return *(end() - 1); }
    reference at(int pos) { return *(begin() + pos); }
    void push_back(const T& x) {
       if (finish != end_of_storage) {
-         construct(finish, x);
+         tinystl::construct(finish, x);
          ++finish;
       } else {
          insert_aux(end(), x);
@@ -72,19 +136,44 @@ class vector {
    }
    void pop_back() {
       --finish;
-      destroy(finish);
+      tinystl::destroy(finish);
    }
 
+   // make room for n elements without changing size()
+   void reserve(size_type n) {
+      if (capacity() >= n) return;
+      iterator new_start = data_allocator::allocate(n);
+      iterator new_finish = new_start;
+      try {
+         new_finish = tinystl::uninitialized_copy(start, finish, new_start);
+      } catch (...) {
+         data_allocator::deallocate(new_start, n);
+         throw;
+      }
+      tinystl::destroy(start, finish);
+      deallocate();
+
+      start = new_start;
+      finish = new_finish;
+      end_of_storage = new_start + n;
+   }
+
+   void insert(iterator pos, size_type n, const T& x);
+
    iterator erase(iterator pos) {
-      if (pos + 1 != end()) std::copy(pos + 1, finish, pos);
+      __OP_SCOPE("vector::erase");
+      __COUNT_OPS(T, __op_copy, finish - pos - 1);
+      if (pos + 1 != end()) tinystl::copy(pos + 1, finish, pos);
       --finish;
-      destroy(finish);
+      tinystl::destroy(finish);
       return pos;
    }
 
    iterator erase(iterator first, iterator last) {
-      iterator i = std::copy(last, finish, first);
-      destroy(i, finish);
+      __OP_SCOPE("vector::erase");
+      __COUNT_OPS(T, __op_copy, finish - last);
+      iterator i = tinystl::copy(last, finish, first);
+      tinystl::destroy(i, finish);
       finish = finish - (last - first);
       return first;
    }
@@ -110,33 +199,35 @@ class vector {
 
 template <class T, class Alloc>
 void vector<T, Alloc>::insert_aux(iterator pos, const T& x) {
+   __OP_SCOPE("vector::insert_aux");
    if (finish != end_of_storage) {
-      construct(finish, *(finish - 1));
+      tinystl::construct(finish, *(finish - 1));
       ++finish;
       T x_copy = x;
-      std::copy_backward(pos, finish - 2, finish - 1);
+      tinystl::copy_backward(pos, finish - 2, finish - 1);
       *pos = x_copy;
+      // x_copy, the shifted elements and the assignment to *pos
+      __COUNT_OPS(T, __op_copy, (finish - 2 - pos) + 2);
    } else {
-      const size_type old_sz = size();
       // if old size is empty then new length is 1
       // else new length is double
-      const size_type len = old_sz != 0 ? 2 * old_sz : 1;
+      const size_type len = __vector_next_capacity(size(), 1);
 
       iterator new_start = data_allocator::allocate(len);
       iterator new_finish = new_start;
       try {
-         new_finish = uninitialized_copy(start, pos, new_start);
-         construct(new_finish, x);
+         new_finish = tinystl::uninitialized_copy(start, pos, new_start);
+         tinystl::construct(new_finish, x);
          ++new_finish;
-         new_finish = uninitialized_copy(pos, finish, new_finish);
+         new_finish = tinystl::uninitialized_copy(pos, finish, new_finish);
       } catch (...) {
          // rollback
-         destroy(new_start, new_finish);
+         tinystl::destroy(new_start, new_finish);
          data_allocator::deallocate(new_start, len);
          throw;
       }
 
-      destroy(begin(), end());
+      tinystl::destroy(begin(), end());
       deallocate();
 
       start = new_start;
@@ -148,6 +239,7 @@ void vector<T, Alloc>::insert_aux(iterator pos, const T& x) {
 template <class T, class Alloc>
 void vector<T, Alloc>::insert(iterator pos, size_type n, const T& x) {
    if (n == 0) return;
+   __OP_SCOPE("vector::insert");
 
    // already have enough space
    if (static_cast<size_type>(end_of_storage - finish) >= n) {
@@ -155,36 +247,36 @@ void vector<T, Alloc>::insert(iterator pos, size_type n, const T& x) {
       const size_type elems_after = finish - pos;
       iterator old_finish = finish;
       if (elems_after > n) {
-         uninitialized_copy(finish - n, finish, finish);
+         tinystl::uninitialized_copy(finish - n, finish, finish);
          finish += n;
-         std::copy_backward(pos, old_finish, finish);
-         finish += elems_after;
-         std::fill(pos, old_finish, x_copy);
+         tinystl::copy_backward(pos, old_finish - n, old_finish);
+         tinystl::fill(pos, pos + n, x_copy);
+         __COUNT_OPS(T, __op_copy, 1 + (old_finish - pos));
       } else {
-         uninitialized_fill_n(finish, n - elems_after, x_copy);
+         tinystl::uninitialized_fill_n(finish, n - elems_after, x_copy);
          finish += n - elems_after;
-         uninitialized_copy(pos, old_finish, finish);
+         tinystl::uninitialized_copy(pos, old_finish, finish);
          finish += elems_after;
-         std::fill(pos, old_finish, x_copy);
+         tinystl::fill(pos, old_finish, x_copy);
+         __COUNT_OPS(T, __op_copy, 1 + (old_finish - pos));
       }
 
    } else {  // does not have enough space
-      const size_type old_size = size();
-      const size_type len = old_size + std::max(old_size, n);
+      const size_type len = __vector_next_capacity(size(), n);
       // allocator new space
       iterator new_start = data_allocator::allocate(len);
       iterator new_finish = new_start;
       try {
-         new_finish = uninitialized_copy(start, pos, new_start);
-         new_finish = uninitialized_fill_n(new_finish, n, x);
-         new_finish = uninitialized_copy(pos, finish, new_finish);
+         new_finish = tinystl::uninitialized_copy(start, pos, new_start);
+         new_finish = tinystl::uninitialized_fill_n(new_finish, n, x);
+         new_finish = tinystl::uninitialized_copy(pos, finish, new_finish);
       } catch (...) {
          // rollback
-         destroy(new_start, new_finish);
+         tinystl::destroy(new_start, new_finish);
          data_allocator::deallocate(new_start, len);
          throw;
       }
-      destroy(start, finish);
+      tinystl::destroy(start, finish);
       deallocate();
 
       start = new_start;
@@ -194,3 +286,5 @@ void vector<T, Alloc>::insert(iterator pos, size_type n, const T& x) {
 }
 
 }  // namespace tinystl
+
+#endif
@@ -1,6 +1,25 @@
 #include <iostream>
 
+#include "tests\algorithm_test.h"
+#include "tests\alloc_test.h"
+#include "tests\basic_string_test.h"
+#include "tests\bit_vector_test.h"
+#include "tests\concurrent_skip_list_test.h"
+#include "tests\concurrent_vector_test.h"
+#include "tests\heap_profiler_test.h"
+#include "tests\instrument_test.h"
 #include "tests\list_test.h"
+#include "tests\lru_cache_test.h"
+#include "tests\mapped_vector_test.h"
+#include "tests\persistent_vector_test.h"
+#include "tests\queue_test.h"
+#include "tests\ranges_test.h"
+#include "tests\ring_buffer_test.h"
+#include "tests\segmented_vector_test.h"
+#include "tests\serialize_test.h"
+#include "tests\slot_map_test.h"
+#include "tests\soa_vector_test.h"
+#include "tests\static_vector_test.h"
 #include "tests\vector_test.h"
 int main(int, char**) {
    test::list_test();